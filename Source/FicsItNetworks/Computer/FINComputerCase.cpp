@@ -117,10 +117,21 @@ void AFINComputerCase::TickActor(float DeltaTime, ELevelTick TickType, FActorTic
 				InternalKernelState = Kernel->GetState();
 				bNetUpdate = true;
 			}
-		}
-		if (OldSerialOutput != SerialOutput) {
-			OldSerialOutput = SerialOutput;
-			bNetUpdate = true;
+			CodersFileSystem::SRef<FFINKernelFSDevDevice> DevDevice = Kernel->GetDevDevice();
+			CodersFileSystem::SRef<FFINKernelFSSerial> Serial = DevDevice ? DevDevice->getSerial() : nullptr;
+			if (Serial) {
+				// a reset of the kernel creates a new serial which starts its output from the beginning
+				if (SerialOutputSerial.get() != Serial.get()) {
+					SerialOutputSerial = Serial;
+					SerialOutputSequence = 0;
+				}
+				if (Serial->getOutputSequence() != SerialOutputSequence) {
+					// append only the new output, so the history (f.e. loaded from the save) is kept
+					SerialOutput.Append(UTF8_TO_TCHAR(Serial->readOutput(SerialOutputSequence).c_str()));
+					SerialOutput = SerialOutput.Right(1000);
+					bNetUpdate = true;
+				}
+			}
 		}
 		if (bNetUpdate) {
 			ForceNetUpdate();
@@ -142,12 +153,6 @@ void AFINComputerCase::Factory_Tick(float dt) {
 			Kernel->Tick(dt);
 			//auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - n);
 			//SML::Logging::debug("Computer tick: ", dur.count());
-		
-			CodersFileSystem::SRef<FFINKernelFSDevDevice> DevDevice = Kernel->GetDevDevice();
-			if (DevDevice && DevDevice->getSerial()) {
-				SerialOutput = SerialOutput.Append(UTF8_TO_TCHAR(DevDevice->getSerial()->readOutput().c_str()));
-				SerialOutput = SerialOutput.Right(1000);
-			}
 		}
 	}
 }
@@ -341,11 +346,13 @@ void AFINComputerCase::Toggle() {
 		case FIN_KERNEL_SHUTOFF:
 			Kernel->Start(false);
 			SerialOutput = "";
+			SerialOutputSequence = 0;
 			ForceNetUpdate();
 			break;
 		case FIN_KERNEL_CRASHED:
 			Kernel->Start(true);
 			SerialOutput = "";
+			SerialOutputSequence = 0;
 			ForceNetUpdate();
 			break;
 		default:
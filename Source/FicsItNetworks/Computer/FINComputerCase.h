@@ -75,7 +75,15 @@ public:
 	UPROPERTY(Replicated)
 	TEnumAsByte<EFINKernelState> InternalKernelState = FIN_KERNEL_SHUTOFF;
 
-	FString OldSerialOutput = "";
+	/**
+	 * The serial output sequence number up to which the output got appended to SerialOutput
+	 */
+	uint64 SerialOutputSequence = 0;
+
+	/**
+	 * The serial SerialOutputSequence refers to
+	 */
+	CodersFileSystem::WRef<FFINKernelFSSerial> SerialOutputSerial;
 
 	float KernelTickTime = 0.0;
 
@@ -0,0 +1,113 @@
+#include "ChunkCache.h"
+
+#include <sstream>
+
+FFINKernelFSChunkCache::FDeviceListener::FDeviceListener(const std::string& deviceKey, CodersFileSystem::WRef<CodersFileSystem::Device> device) : deviceKey(deviceKey), device(device) {}
+
+void FFINKernelFSChunkCache::FDeviceListener::onNodeRemoved(CodersFileSystem::Path path, CodersFileSystem::NodeType type) {
+	FFINKernelFSChunkCache& cache = Get();
+	std::lock_guard<std::mutex> Lock(cache.mutex);
+	cache.invalidate(deviceKey, path);
+}
+
+void FFINKernelFSChunkCache::FDeviceListener::onNodeChanged(CodersFileSystem::Path path, CodersFileSystem::NodeType type) {
+	FFINKernelFSChunkCache& cache = Get();
+	std::lock_guard<std::mutex> Lock(cache.mutex);
+	cache.invalidate(deviceKey, path);
+}
+
+void FFINKernelFSChunkCache::FDeviceListener::onNodeRenamed(CodersFileSystem::Path newPath, CodersFileSystem::Path oldPath, CodersFileSystem::NodeType type) {
+	FFINKernelFSChunkCache& cache = Get();
+	std::lock_guard<std::mutex> Lock(cache.mutex);
+	cache.invalidate(deviceKey, oldPath);
+	cache.invalidate(deviceKey, newPath);
+}
+
+FFINKernelFSChunkCache& FFINKernelFSChunkCache::Get() {
+	static FFINKernelFSChunkCache cache;
+	return cache;
+}
+
+std::string FFINKernelFSChunkCache::getDeviceKey(CodersFileSystem::Device* device) {
+	CodersFileSystem::DiskDevice* disk = dynamic_cast<CodersFileSystem::DiskDevice*>(device);
+	if (disk) return "disk:" + disk->getRealPath().generic_string();
+	std::stringstream key;
+	key << "device:" << static_cast<const void*>(device);
+	return key.str();
+}
+
+std::string FFINKernelFSChunkCache::getEntryKey(const std::string& deviceKey, const CodersFileSystem::Path& path) {
+	return deviceKey + "|" + path.absolute().str();
+}
+
+void FFINKernelFSChunkCache::listenTo(CodersFileSystem::SRef<CodersFileSystem::Device> device, const std::string& deviceKey) {
+	{
+		std::lock_guard<std::mutex> Lock(deviceListenersMutex);
+		for (auto i = deviceListeners.begin(); i != deviceListeners.end();) {
+			if (!i->second->device.isValid()) i = deviceListeners.erase(i);
+			else ++i;
+		}
+		const auto existing = deviceListeners.find(device.get());
+		if (existing != deviceListeners.end() && existing->second->device.get() == device.get()) return;
+	}
+
+	// the device notifies its listeners while it is locked, so register while holding the lock too
+	CodersFileSystem::SRef<FDeviceListener> listener = new FDeviceListener(deviceKey, device);
+	{
+		std::unique_lock<std::shared_mutex> DeviceLock(device->mutex);
+		device->addListener(listener);
+	}
+	std::lock_guard<std::mutex> Lock(deviceListenersMutex);
+	deviceListeners[device.get()] = listener;
+}
+
+void FFINKernelFSChunkCache::invalidate(const std::string& deviceKey, const CodersFileSystem::Path& path) {
+	const std::string key = getEntryKey(deviceKey, path);
+	// the root path ends with the separator already
+	const std::string childPrefix = key.back() == '/' ? key : key + "/";
+	for (auto i = entries.lower_bound(key); i != entries.end();) {
+		if (i->first == key || i->first.compare(0, childPrefix.size(), childPrefix) == 0) {
+			cacheSize -= i->second.getSize();
+			i = entries.erase(i);
+		} else if (i->first.compare(0, key.size(), key) == 0) {
+			// a sibling sharing the name as prefix, like "file.lua" and "file.lua.bak"
+			++i;
+		} else {
+			break;
+		}
+	}
+}
+
+bool FFINKernelFSChunkCache::get(CodersFileSystem::SRef<CodersFileSystem::Device> device, const CodersFileSystem::Path& path, const std::string& source, std::string& outChunk) {
+	if (!device.isValid()) return false;
+	const std::string key = getEntryKey(getDeviceKey(device.get()), path);
+	std::lock_guard<std::mutex> Lock(mutex);
+	const auto entry = entries.find(key);
+	if (entry == entries.end()) return false;
+	if (entry->second.source != source) return false;
+	outChunk = entry->second.chunk;
+	return true;
+}
+
+void FFINKernelFSChunkCache::put(CodersFileSystem::SRef<CodersFileSystem::Device> device, const CodersFileSystem::Path& path, const std::string& source, std::string chunk) {
+	if (!device.isValid() || source.size() + chunk.size() > MaxCacheSize) return;
+	const std::string deviceKey = getDeviceKey(device.get());
+	listenTo(device, deviceKey);
+
+	std::lock_guard<std::mutex> Lock(mutex);
+	invalidate(deviceKey, path);
+	if (cacheSize + source.size() + chunk.size() > MaxCacheSize) {
+		entries.clear();
+		cacheSize = 0;
+	}
+	FChunkEntry& entry = entries[getEntryKey(deviceKey, path)];
+	entry.source = source;
+	entry.chunk = std::move(chunk);
+	cacheSize += entry.getSize();
+}
+
+void FFINKernelFSChunkCache::clear() {
+	std::lock_guard<std::mutex> Lock(mutex);
+	entries.clear();
+	cacheSize = 0;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Library/Device.h"
+#include <map>
+#include <mutex>
+
+/**
+ * Caches the compiled Lua chunks of files loaded from kernel file systems, shared by all kernels of the process,
+ * so the chunks stay warm across reboots, resets and loads of computers.
+ * An entry is keyed by the device and the path of the file within the device and stores the source it got compiled from,
+ * so a changed file never hits a stale entry even if no change event got emitted (yet).
+ * Disk devices are identified by their real path, so recreated devices of the same drive share their entries.
+ * The cache listens to the node changes of every device it holds entries of (for disk devices reported by their watcher)
+ * to free the entries early.
+ */
+class FICSITNETWORKS_API FFINKernelFSChunkCache {
+public:
+	/**
+	 * The maximum amount of bytes of compiled chunks and their sources the cache holds before it gets flushed
+	 */
+	static constexpr size_t MaxCacheSize = 8 * 1024 * 1024;
+
+private:
+	struct FChunkEntry {
+		std::string source;
+		std::string chunk;
+
+		size_t getSize() const {
+			return source.size() + chunk.size();
+		}
+	};
+
+	/**
+	 * Listens to the node changes of one device and invalidates the entries of the changed nodes
+	 */
+	class FDeviceListener : public CodersFileSystem::Listener {
+	public:
+		std::string deviceKey;
+		CodersFileSystem::WRef<CodersFileSystem::Device> device;
+
+		FDeviceListener(const std::string& deviceKey, CodersFileSystem::WRef<CodersFileSystem::Device> device);
+
+		virtual void onNodeRemoved(CodersFileSystem::Path path, CodersFileSystem::NodeType type) override;
+		virtual void onNodeChanged(CodersFileSystem::Path path, CodersFileSystem::NodeType type) override;
+		virtual void onNodeRenamed(CodersFileSystem::Path newPath, CodersFileSystem::Path oldPath, CodersFileSystem::NodeType type) override;
+	};
+
+	std::map<std::string, FChunkEntry> entries;
+	size_t cacheSize = 0;
+	std::mutex mutex;
+
+	/**
+	 * The listeners registered at the devices by device, devices that don't exist anymore get pruned on registration
+	 */
+	std::map<CodersFileSystem::Device*, CodersFileSystem::SRef<FDeviceListener>> deviceListeners;
+	std::mutex deviceListenersMutex;
+
+	/**
+	 * Returns the key identifying the given device
+	 */
+	static std::string getDeviceKey(CodersFileSystem::Device* device);
+
+	/**
+	 * Returns the key of the entry of the given path within the given device
+	 */
+	static std::string getEntryKey(const std::string& deviceKey, const CodersFileSystem::Path& path);
+
+	/**
+	 * Registers a listener at the given device if there is none yet
+	 */
+	void listenTo(CodersFileSystem::SRef<CodersFileSystem::Device> device, const std::string& deviceKey);
+
+	/**
+	 * Removes the entry of the given path within the given device and all entries of nodes within it.
+	 * Expects the mutex to be locked.
+	 */
+	void invalidate(const std::string& deviceKey, const CodersFileSystem::Path& path);
+
+public:
+	static FFINKernelFSChunkCache& Get();
+
+	/**
+	 * Looks up the compiled chunk of the file at the given path of the given device.
+	 *
+	 * @param[in]	device		the device the source got read from
+	 * @param[in]	path		the path of the file within the device
+	 * @param[in]	source		the current content of the file
+	 * @param[out]	outChunk	the compiled chunk if it was found
+	 * @return	true if a chunk compiled from exactly the given source was found
+	 */
+	bool get(CodersFileSystem::SRef<CodersFileSystem::Device> device, const CodersFileSystem::Path& path, const std::string& source, std::string& outChunk);
+
+	/**
+	 * Stores the compiled chunk of the file at the given path of the given device.
+	 *
+	 * @param[in]	device	the device the source got read from
+	 * @param[in]	path	the path of the file within the device
+	 * @param[in]	source	the content of the file the chunk got compiled from
+	 * @param[in]	chunk	the compiled chunk
+	 */
+	void put(CodersFileSystem::SRef<CodersFileSystem::Device> device, const CodersFileSystem::Path& path, const std::string& source, std::string chunk);
+
+	/**
+	 * Removes all cached chunks
+	 */
+	void clear();
+};
@@ -13,6 +13,7 @@ CodersFileSystem::SRef<CodersFileSystem::FileStream> FFINKernelFSDevDevice::open
 }
 
 CodersFileSystem::SRef<CodersFileSystem::Node> FFINKernelFSDevDevice::get(CodersFileSystem::Path path) {
+	std::shared_lock<std::shared_mutex> Lock(DevicesMutex);
 	try {
 		return new CodersFileSystem::DeviceNode(Devices.at(path.str()));
 	} catch (...) {
@@ -34,6 +35,7 @@ bool FFINKernelFSDevDevice::rename(CodersFileSystem::Path path, const std::strin
 
 std::unordered_set<std::string> FFINKernelFSDevDevice::childs(CodersFileSystem::Path path) {
 	std::unordered_set<std::string> list;
+	std::shared_lock<std::shared_mutex> Lock(DevicesMutex);
 	for (auto device : Devices) {
 		list.insert(device.first);
 	}
@@ -42,6 +44,7 @@ std::unordered_set<std::string> FFINKernelFSDevDevice::childs(CodersFileSystem::
 }
 
 bool FFINKernelFSDevDevice::addDevice(CodersFileSystem::SRef<CodersFileSystem::Device> device, const std::string& name) {
+	std::unique_lock<std::shared_mutex> Lock(DevicesMutex);
 	const auto dev = Devices.find(name);
 	if (dev != Devices.end() || name == "serial") return false;
 	Devices[name] = device;
@@ -49,6 +52,7 @@ bool FFINKernelFSDevDevice::addDevice(CodersFileSystem::SRef<CodersFileSystem::D
 }
 
 bool FFINKernelFSDevDevice::removeDevice(CodersFileSystem::SRef<CodersFileSystem::Device> device) {
+	std::unique_lock<std::shared_mutex> Lock(DevicesMutex);
 	for (auto d = Devices.begin(); d != Devices.end(); d++) {
 		if (d->second == device) {
 			Devices.erase(d);
@@ -59,19 +63,21 @@ bool FFINKernelFSDevDevice::removeDevice(CodersFileSystem::SRef<CodersFileSystem
 }
 
 std::unordered_map<std::string, CodersFileSystem::SRef<CodersFileSystem::Device>> FFINKernelFSDevDevice::getDevices() const {
+	std::shared_lock<std::shared_mutex> Lock(DevicesMutex);
 	return Devices;
 }
 
 void FFINKernelFSDevDevice::updateCapacity(std::int64_t capacity) {
-	for (auto& device : Devices) {
+	for (auto& device : getDevices()) {
 		if (CodersFileSystem::MemDevice* memDev = dynamic_cast<CodersFileSystem::MemDevice*>(device.second.get())) {
+			std::unique_lock<std::shared_mutex> Lock(memDev->mutex);
 			memDev->capacity = memDev->getUsed() + capacity;
 		}
 	}
 }
 
 void FFINKernelFSDevDevice::tickListeners() {
-	for (auto& device : Devices) {
+	for (auto& device : getDevices()) {
 		if (CodersFileSystem::DiskDevice* diskDev = dynamic_cast<CodersFileSystem::DiskDevice*>(device.second.get())) {
 			diskDev->tickWatcher();
 		}
@@ -6,6 +6,7 @@
 class FICSITNETWORKS_API FFINKernelFSDevDevice : public CodersFileSystem::Device {
 private:
 	std::unordered_map<std::string, CodersFileSystem::SRef<CodersFileSystem::Device>> Devices;
+	mutable std::shared_mutex DevicesMutex;
 	CodersFileSystem::SRef<FFINKernelFSSerial> Serial;
 
 public:
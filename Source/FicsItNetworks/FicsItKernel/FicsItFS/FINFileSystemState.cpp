@@ -1,14 +1,49 @@
 #include "FINFileSystemState.h"
 
+#include "EngineUtils.h"
 #include "FGSaveSystem.h"
 #include "TimerManager.h"
 #include "FicsItNetworks/FicsItNetworksModule.h"
+#include "FicsItNetworks/FicsItNetworksCustomVersion.h"
+#include "FicsItNetworks/Computer/FINComputerSubsystem.h"
+#include "Misc/Compression.h"
 #include "Framework/Application/SlateApplication.h"
 #include "Widgets/Input/SButton.h"
 #include "Widgets/Layout/SBox.h"
 #include "Widgets/Layout/SGridPanel.h"
 #include "Widgets/Text/STextBlock.h"
 
+TSharedRef<FFINFileSystemBlob> FFINFileSystemBlob::Create(const std::string& RawData) {
+	TSharedRef<FFINFileSystemBlob> Blob = MakeShared<FFINFileSystemBlob>();
+	Blob->RawSize = RawData.length();
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, static_cast<int32>(RawData.length()));
+	Blob->Data.SetNumUninitialized(CompressedSize);
+	if (RawData.length() > 0 && FCompression::CompressMemory(NAME_Zlib, Blob->Data.GetData(), CompressedSize, RawData.data(), static_cast<int32>(RawData.length())) && CompressedSize < Blob->RawSize) {
+		Blob->Data.SetNum(CompressedSize);
+		Blob->bCompressed = true;
+	} else {
+		Blob->Data = TArray<uint8>(reinterpret_cast<const uint8*>(RawData.data()), RawData.length());
+	}
+	return Blob;
+}
+
+std::string FFINFileSystemBlob::GetRawData() const {
+	if (!bCompressed) return std::string(reinterpret_cast<const char*>(Data.GetData()), Data.Num());
+	std::string RawData;
+	RawData.resize(RawSize);
+	if (!FCompression::UncompressMemory(NAME_Zlib, RawData.data(), static_cast<int32>(RawSize), Data.GetData(), Data.Num())) {
+		UE_LOG(LogFicsItNetworks, Error, TEXT("Unable to decompress file system content"));
+		RawData.clear();
+	}
+	return RawData;
+}
+
+static void SerializeBlob(FStructuredArchive::FRecord Record, FFINFileSystemBlob& Blob) {
+	Record.EnterField(SA_FIELD_NAME(TEXT("RawSize"))) << Blob.RawSize;
+	Record.EnterField(SA_FIELD_NAME(TEXT("Compressed"))) << Blob.bCompressed;
+	Record.EnterField(SA_FIELD_NAME(TEXT("Data"))) << Blob.Data;
+}
+
 AFINFileSystemState::AFINFileSystemState() {
 	RootComponent = CreateDefaultSubobject<USceneComponent>(L"RootComponent");
 }
@@ -78,7 +113,7 @@ int AskForDiskOrSave(FString Name) {
 		if (KeepDisk == 1) return; \
 	}
 
-void AFINFileSystemState::SerializePath(CodersFileSystem::SRef<CodersFileSystem::Device> SerializeDevice, FStructuredArchive::FRecord Record, CodersFileSystem::Path Path, FString Name, int& KeepDisk) {
+void AFINFileSystemState::SerializePath(CodersFileSystem::SRef<CodersFileSystem::Device> SerializeDevice, FStructuredArchive::FRecord Record, CodersFileSystem::Path Path, FString Name, int& KeepDisk, TMap<FSHAHash, TSharedPtr<FFINFileSystemBlob>>* Blobs) {
 	std::unordered_set<std::string> childs;
 	std::unordered_set<std::string>::iterator childIterator;
 	int ChildNodeNum;
@@ -129,35 +164,104 @@ void AFINFileSystemState::SerializePath(CodersFileSystem::SRef<CodersFileSystem:
 			if (KeepDisk == 0) {
 				SerializeDevice->remove(Path / stdChildName, true);
 			}
-			FStructuredArchive::FSlot Content = Child.EnterField(SA_FIELD_NAME(TEXT("FileContent")));
-			if (Record.GetUnderlyingArchive().IsLoading()) {
-				std::string diskData;
-				if (KeepDisk == -1) diskData = CodersFileSystem::FileStream::readAll(SerializeDevice->open(Path / stdChildName, CodersFileSystem::INPUT | CodersFileSystem::BINARY));
-				FString Data;
-				Content << Data;
-				FTCHARToUTF8 Convert(*Data, Data.Len());
-				std::string stdData = std::string(Convert.Get(), Convert.Length());
-				CheckKeepDisk(diskData != stdData)
-				if (KeepDisk == 0) {
-					CodersFileSystem::SRef<CodersFileSystem::FileStream> Stream = SerializeDevice->open(Path / stdChildName, CodersFileSystem::OUTPUT | CodersFileSystem::TRUNC | CodersFileSystem::BINARY);
-					Stream->write(stdData);
+			if (Blobs) {
+				FString HashString;
+				TSharedPtr<FFINFileSystemBlob> InlineBlob;
+				if (bIsSaving) {
+					const FFINFileSystemFileCache* Cache = FileCache.Find(UTF8_TO_TCHAR((Path / stdChildName).absolute().str().c_str()));
+					if (Cache && Blobs->Contains(Cache->Hash)) {
+						HashString = Cache->Hash.ToString();
+					} else {
+						// the content wasn't collected (f.e. the file got created in the meantime), store it inline instead
+						CodersFileSystem::SRef<CodersFileSystem::FileStream> Stream = SerializeDevice->open(Path / stdChildName, CodersFileSystem::INPUT | CodersFileSystem::BINARY);
+						if (Stream.isValid()) {
+							InlineBlob = FFINFileSystemBlob::Create(CodersFileSystem::FileStream::readAll(Stream));
+							Stream->close();
+						} else {
+							UE_LOG(LogFicsItNetworks, Error, TEXT("Unable to save the content of file '%s' of file system '%s'"), UTF8_TO_TCHAR((Path / stdChildName).str().c_str()), *Name);
+							Record.GetUnderlyingArchive().SetError();
+							InlineBlob = MakeShared<FFINFileSystemBlob>();
+						}
+					}
+				}
+				Child.EnterField(SA_FIELD_NAME(TEXT("Hash"))) << HashString;
+				if (HashString.IsEmpty()) {
+					if (bIsLoading) InlineBlob = MakeShared<FFINFileSystemBlob>();
+					SerializeBlob(Child.EnterField(SA_FIELD_NAME(TEXT("Content"))).EnterRecord(), *InlineBlob);
+				}
+				if (bIsLoading) {
+					FSHAHash Hash;
+					TSharedPtr<FFINFileSystemBlob>* Blob;
+					if (InlineBlob) {
+						const std::string RawData = InlineBlob->GetRawData();
+						FSHA1::HashBuffer(RawData.data(), RawData.length(), Hash.Hash);
+						Blob = &InlineBlob;
+					} else {
+						Hash.FromString(HashString);
+						Blob = Blobs->Find(Hash);
+					}
+					if (KeepDisk == -1) {
+						const FFINFileSystemFileCache* Cache = nullptr;
+						CodersFileSystem::SRef<CodersFileSystem::DiskDevice> Disk = SerializeDevice;
+						std::error_code Error;
+						int64 DiskSize = Disk.isValid() ? std::filesystem::file_size(Disk->getRealPath() / (Path / stdChildName).relative().str(), Error) : -1;
+						// only hash the disk file if the size already matches
+						if (Blob && !Error && DiskSize == (*Blob)->RawSize) Cache = GetFileCache(SerializeDevice, Path / stdChildName);
+						CheckKeepDisk(!Cache || !(Cache->Hash == Hash))
+					}
+					if (KeepDisk == 0) {
+						std::string stdData;
+						if (Blob) stdData = (*Blob)->GetRawData();
+						CodersFileSystem::SRef<CodersFileSystem::FileStream> Stream = SerializeDevice->open(Path / stdChildName, CodersFileSystem::OUTPUT | CodersFileSystem::TRUNC | CodersFileSystem::BINARY);
+						Stream->write(stdData);
+						Stream->close();
+
+						// the written content is known, so the next save doesn't need to read it again
+						CodersFileSystem::SRef<CodersFileSystem::DiskDevice> Disk = SerializeDevice;
+						FString CacheKey = UTF8_TO_TCHAR((Path / stdChildName).absolute().str().c_str());
+						std::error_code Error;
+						int64 Timestamp = Disk.isValid() ? std::filesystem::last_write_time(Disk->getRealPath() / (Path / stdChildName).relative().str(), Error).time_since_epoch().count() : 0;
+						if (Blob && Disk.isValid() && !Error) {
+							FFINFileSystemFileCache& Cache = FileCache.FindOrAdd(CacheKey);
+							Cache.Timestamp = Timestamp;
+							Cache.Size = stdData.length();
+							Cache.Hash = Hash;
+						} else {
+							FileCache.Remove(CacheKey);
+						}
+					}
+				}
+			} else {
+				FStructuredArchive::FSlot Content = Child.EnterField(SA_FIELD_NAME(TEXT("FileContent")));
+				if (Record.GetUnderlyingArchive().IsLoading()) {
+					std::string diskData;
+					if (KeepDisk == -1) diskData = CodersFileSystem::FileStream::readAll(SerializeDevice->open(Path / stdChildName, CodersFileSystem::INPUT | CodersFileSystem::BINARY));
+					FString Data;
+					Content << Data;
+					FTCHARToUTF8 Convert(*Data, Data.Len());
+					std::string stdData = std::string(Convert.Get(), Convert.Length());
+					CheckKeepDisk(diskData != stdData)
+					if (KeepDisk == 0) {
+						CodersFileSystem::SRef<CodersFileSystem::FileStream> Stream = SerializeDevice->open(Path / stdChildName, CodersFileSystem::OUTPUT | CodersFileSystem::TRUNC | CodersFileSystem::BINARY);
+						Stream->write(stdData);
+						Stream->close();
+					}
+				} else if (Record.GetUnderlyingArchive().IsSaving()) {
+					CodersFileSystem::SRef<CodersFileSystem::FileStream> Stream = SerializeDevice->open(Path / stdChildName, CodersFileSystem::INPUT | CodersFileSystem::BINARY);
+					std::string RawData = CodersFileSystem::FileStream::readAll(Stream);
 					Stream->close();
+					FUTF8ToTCHAR Convert(RawData.c_str(), RawData.length());
+					FString Data(Convert.Length(), Convert.Get());
+					Content << Data;
 				}
-            } else if (Record.GetUnderlyingArchive().IsSaving()) {
-            	CodersFileSystem::SRef<CodersFileSystem::FileStream> Stream = SerializeDevice->open(Path / stdChildName, CodersFileSystem::INPUT | CodersFileSystem::BINARY);
-            	std::string RawData = CodersFileSystem::FileStream::readAll(Stream);
-            	Stream->close();
-            	FUTF8ToTCHAR Convert(RawData.c_str(), RawData.length());
-            	FString Data(Convert.Length(), Convert.Get());
-            	Content << Data;
-            }
+			}
 		} else if (Type == 2) {
 			CheckKeepDisk(!CodersFileSystem::SRef<CodersFileSystem::Directory>(SerializeDevice->get(Path / stdChildName)).isValid())
 			if (KeepDisk == 0) {
 				SerializeDevice->remove(Path / stdChildName, true);
 			}
 			SerializeDevice->createDir(Path / stdChildName);
-			SerializePath(SerializeDevice, Child, Path / stdChildName, Name, KeepDisk);
+			SerializePath(SerializeDevice, Child, Path / stdChildName, Name, KeepDisk, Blobs);
 			if (KeepDisk == 1) return;
 		}
 	}
@@ -177,6 +281,42 @@ void AFINFileSystemState::Serialize(FStructuredArchive::FRecord Record) {
 		//SerializeDevice->remove("/", true);
 	}
 	
+	if (!bUseOldSerialization && AFINComputerSubsystem::GetComputerSubsystem(this)->Version >= FINContentHashedFileSystem) {
+		TMap<FSHAHash, TSharedPtr<FFINFileSystemBlob>> Blobs;
+		if (Record.GetUnderlyingArchive().IsSaving()) {
+			TMap<FString, FFINFileSystemFileCache> NewCache;
+			CollectBlobs(SerializeDevice, "/", NewCache, Blobs);
+			FileCache = MoveTemp(NewCache);
+		}
+
+		int32 BlobNum = Blobs.Num();
+		TArray<FSHAHash> BlobHashes;
+		Blobs.GenerateKeyArray(BlobHashes);
+		FStructuredArchive::FArray BlobArray = Record.EnterArray(SA_FIELD_NAME(TEXT("Blobs")), BlobNum);
+		for (int32 i = 0; i < BlobNum; ++i) {
+			FStructuredArchive::FRecord BlobRecord = BlobArray.EnterElement().EnterRecord();
+			FString HashString;
+			TSharedPtr<FFINFileSystemBlob> Blob;
+			if (Record.GetUnderlyingArchive().IsSaving()) {
+				HashString = BlobHashes[i].ToString();
+				Blob = Blobs[BlobHashes[i]];
+			} else {
+				Blob = MakeShared<FFINFileSystemBlob>();
+			}
+			BlobRecord.EnterField(SA_FIELD_NAME(TEXT("Hash"))) << HashString;
+			SerializeBlob(BlobRecord, *Blob);
+			if (Record.GetUnderlyingArchive().IsLoading()) {
+				FSHAHash Hash;
+				Hash.FromString(HashString);
+				Blobs.Add(Hash, Blob);
+			}
+		}
+		
+		int KeepDisk = -1;
+		SerializePath(SerializeDevice, Record.EnterField(SA_FIELD_NAME(TEXT("RootNode"))).EnterRecord(), "/", ID.ToString(), KeepDisk, &Blobs);
+		return;
+	}
+
 	FStructuredArchive::FSlot RootNode = Record.EnterField(SA_FIELD_NAME(TEXT("RootNode")));
 	if (!bUseOldSerialization) {
 		int KeepDisk = -1;
@@ -187,6 +327,51 @@ void AFINFileSystemState::Serialize(FStructuredArchive::FRecord Record) {
 	}
 }
 
+const FFINFileSystemFileCache* AFINFileSystemState::GetFileCache(CodersFileSystem::SRef<CodersFileSystem::Device> SerializeDevice, CodersFileSystem::Path Path, TMap<FSHAHash, TSharedPtr<FFINFileSystemBlob>>* Blobs) {
+	CodersFileSystem::SRef<CodersFileSystem::DiskDevice> Disk = SerializeDevice;
+	if (!Disk.isValid()) return nullptr;
+	std::filesystem::path RealPath = Disk->getRealPath() / Path.relative().str();
+	std::error_code Error;
+	int64 Timestamp = std::filesystem::last_write_time(RealPath, Error).time_since_epoch().count();
+	if (Error) return nullptr;
+	int64 Size = std::filesystem::file_size(RealPath, Error);
+	if (Error) return nullptr;
+	
+	FString CacheKey = UTF8_TO_TCHAR(Path.absolute().str().c_str());
+	FFINFileSystemFileCache* Cache = FileCache.Find(CacheKey);
+	bool bUpToDate = Cache && Cache->Timestamp == Timestamp && Cache->Size == Size;
+	if (bUpToDate && (!Blobs || Blobs->Contains(Cache->Hash))) return Cache;
+
+	// the blobs only live for a single save, so unchanged files get read again if their content is needed
+	CodersFileSystem::SRef<CodersFileSystem::FileStream> Stream = SerializeDevice->open(Path, CodersFileSystem::INPUT | CodersFileSystem::BINARY);
+	if (!Stream.isValid()) {
+		FileCache.Remove(CacheKey);
+		return nullptr;
+	}
+	std::string RawData = CodersFileSystem::FileStream::readAll(Stream);
+	Stream->close();
+	Cache = &FileCache.FindOrAdd(CacheKey);
+	FSHA1::HashBuffer(RawData.data(), RawData.length(), Cache->Hash.Hash);
+	Cache->Timestamp = Timestamp;
+	Cache->Size = Size;
+	if (Blobs && !Blobs->Contains(Cache->Hash)) Blobs->Add(Cache->Hash, FFINFileSystemBlob::Create(RawData));
+	return Cache;
+}
+
+void AFINFileSystemState::CollectBlobs(CodersFileSystem::SRef<CodersFileSystem::Device> SerializeDevice, CodersFileSystem::Path Path, TMap<FString, FFINFileSystemFileCache>& OutCache, TMap<FSHAHash, TSharedPtr<FFINFileSystemBlob>>& OutBlobs) {
+	for (const std::string& ChildName : SerializeDevice->childs(Path)) {
+		CodersFileSystem::SRef<CodersFileSystem::Node> ChildNode = SerializeDevice->get(Path / ChildName);
+		if (dynamic_cast<CodersFileSystem::File*>(ChildNode.get())) {
+			const FFINFileSystemFileCache* Cache = GetFileCache(SerializeDevice, Path / ChildName, &OutBlobs);
+			// files without collected content get stored inline by SerializePath
+			if (!Cache) continue;
+			OutCache.Add(UTF8_TO_TCHAR((Path / ChildName).absolute().str().c_str()), *Cache);
+		} else if (dynamic_cast<CodersFileSystem::Directory*>(ChildNode.get())) {
+			CollectBlobs(SerializeDevice, Path / ChildName, OutCache, OutBlobs);
+		}
+	}
+}
+
 void AFINFileSystemState::BeginPlay() {
 	Super::BeginPlay();
 	GetDevice();
@@ -244,10 +429,26 @@ AFINFileSystemState* AFINFileSystemState::CreateState(UObject* WorldContextObjec
 
 void AFINFileSystemState::UpdateUsage() {
 	CodersFileSystem::SRef<CodersFileSystem::ByteCountedDevice> UsageDevice = GetDevice();
+	// the disk device keeps its usage up to date from the watcher events, no need to scan the drive
+	CodersFileSystem::SRef<CodersFileSystem::DiskDevice> Disk = UsageDevice;
+	if (Disk) Disk->tickWatcher();
 	if (Device) Usage = UsageDevice->getUsed();
 	else Usage = 0.0f;
 }
 
+static FAutoConsoleCommandWithWorldAndArgs LogNodeCacheStatsCommand(
+	TEXT("FIN.LogNodeCacheStats"),
+	TEXT("Logs the node and child list lookups of every drive served by the node cache and the ones that had to query the real file system."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World) {
+		for (TActorIterator<AFINFileSystemState> State(World); State; ++State) {
+			CodersFileSystem::SRef<CodersFileSystem::DiskDevice> Disk = State->GetDevice();
+			if (!Disk.isValid()) continue;
+			const uint64 Hits = Disk->getNodeCacheHits();
+			const uint64 Misses = Disk->getNodeCacheMisses();
+			UE_LOG(LogFicsItNetworks, Display, TEXT("Node cache of drive '%s': %llu hits, %llu misses (%.1f%% hit rate)"), *State->ID.ToString(), Hits, Misses, Hits + Misses > 0 ? 100.0 * Hits / (Hits + Misses) : 0.0);
+		}
+	}));
+
 void AFINFileSystemState::Serialize_DEPRECATED(FArchive& Ar) {
 	if (!Ar.IsSaveGame()) return;
 	
@@ -4,8 +4,38 @@
 #include "GameFramework/Actor.h"
 #include "FGInventoryComponent.h"
 #include "FicsItNetworks/FicsItKernel/FicsItFS/FileSystem.h"
+#include "Misc/SecureHash.h"
 #include "FINFileSystemState.generated.h"
 
+/**
+ * The content of a file how it gets stored in the save game.
+ * Gets compressed if that makes it smaller.
+ */
+struct FICSITNETWORKS_API FFINFileSystemBlob {
+	TArray<uint8> Data;
+	int64 RawSize = 0;
+	bool bCompressed = false;
+
+	/**
+	 * Creates a new blob holding the given raw file content
+	 */
+	static TSharedRef<FFINFileSystemBlob> Create(const std::string& RawData);
+
+	/**
+	 * Returns the raw file content stored in this blob
+	 */
+	std::string GetRawData() const;
+};
+
+/**
+ * Caches the hash of a file on disk, so files which didn't change since the last save or load don't need to be hashed again.
+ */
+struct FICSITNETWORKS_API FFINFileSystemFileCache {
+	int64 Timestamp = 0;
+	int64 Size = 0;
+	FSHAHash Hash;
+};
+
 UCLASS()
 class FICSITNETWORKS_API AFINFileSystemState : public AActor, public IFGSaveInterface {
 	GENERATED_BODY()
@@ -14,9 +44,31 @@ private:
 	CodersFileSystem::SRef<CodersFileSystem::Device> Device;
 
 	bool bUseOldSerialization = false;
+
+	/**
+	 * Cached file hashes by absolute file path within the device
+	 */
+	TMap<FString, FFINFileSystemFileCache> FileCache;
+
+	/**
+	 * Returns the up-to-date cache entry of the given file, only reads the file if its timestamp or size changed.
+	 * If Blobs is given, also makes sure it contains the content of the file, reading the file if needed.
+	 * Returns nullptr if the file doesn't exist or can't be read.
+	 */
+	const FFINFileSystemFileCache* GetFileCache(CodersFileSystem::SRef<CodersFileSystem::Device> SerializeDevice, CodersFileSystem::Path Path, TMap<FSHAHash, TSharedPtr<FFINFileSystemBlob>>* Blobs = nullptr);
+
+	/**
+	 * Updates the file cache of every file in the given directory and collects their deduplicated content.
+	 */
+	void CollectBlobs(CodersFileSystem::SRef<CodersFileSystem::Device> SerializeDevice, CodersFileSystem::Path Path, TMap<FString, FFINFileSystemFileCache>& OutCache, TMap<FSHAHash, TSharedPtr<FFINFileSystemBlob>>& OutBlobs);
 	
 public:
-	static void SerializePath(CodersFileSystem::SRef<CodersFileSystem::Device> SerializeDevice, FStructuredArchive::FRecord Record, CodersFileSystem::Path Path, FString Name, int& KeepDisk);
+	/**
+	 * Serializes the directory tree at the given path.
+	 * If Blobs is given, files reference their content by hash, files without collected content store it inline as blob.
+	 * Otherwise the content is stored inline as string (old format).
+	 */
+	void SerializePath(CodersFileSystem::SRef<CodersFileSystem::Device> SerializeDevice, FStructuredArchive::FRecord Record, CodersFileSystem::Path Path, FString Name, int& KeepDisk, TMap<FSHAHash, TSharedPtr<FFINFileSystemBlob>>* Blobs = nullptr);
 
 	UPROPERTY(SaveGame)
 	FGuid ID;
@@ -14,8 +14,11 @@ bool FFINKernelFSRoot::mount(CodersFileSystem::SRef<CodersFileSystem::Device> de
 
 bool FFINKernelFSRoot::unmount(CodersFileSystem::Path path) {
 	// check if mount is DevDevice & if it is, prevent unmount
-	const auto mount = mounts.find(path);
-	if (mount != mounts.end() && dynamic_cast<FFINKernelFSDevDevice*>(mount->second.first.get())) return false;
+	{
+		std::shared_lock<std::shared_mutex> Lock(mountsMutex);
+		const auto mount = mounts.find(path);
+		if (mount != mounts.end() && dynamic_cast<FFINKernelFSDevDevice*>(mount->second.first.get())) return false;
+	}
 
 	return FileSystemRoot::unmount(path);
 }
@@ -23,6 +26,7 @@ bool FFINKernelFSRoot::unmount(CodersFileSystem::Path path) {
 bool FFINKernelFSRoot::unmount(CodersFileSystem::SRef<CodersFileSystem::Device> device) {
 	CodersFileSystem::Path p;
 	bool found = false;
+	std::shared_lock<std::shared_mutex> Lock(mountsMutex);
 	for (auto m : mounts) {
 		if (m.second.first == device) {
 			p = m.first;
@@ -30,23 +34,45 @@ bool FFINKernelFSRoot::unmount(CodersFileSystem::SRef<CodersFileSystem::Device>
 			break;
 		}
 	}
+	Lock.unlock();
 	if (found) return unmount(p);
 	return false;
 }
 
 int64 FFINKernelFSRoot::getMemoryUsage(bool recalc) {
 	int64 memoryUsage = 0;
-	for (auto m : mounts) {
-		CodersFileSystem::SRef<CodersFileSystem::MemDevice> tmpDev = m.second.first;
-		if (tmpDev.isValid()) {
-			if (recalc) memoryUsage += tmpDev->getSize();
-			else memoryUsage += tmpDev->getUsed();
+	std::vector<CodersFileSystem::SRef<CodersFileSystem::MemDevice>> tmpDevs;
+	{
+		std::shared_lock<std::shared_mutex> Lock(mountsMutex);
+		for (auto m : mounts) {
+			CodersFileSystem::SRef<CodersFileSystem::MemDevice> tmpDev = m.second.first;
+			if (tmpDev.isValid()) tmpDevs.push_back(tmpDev);
 		}
 	}
+	for (const CodersFileSystem::SRef<CodersFileSystem::MemDevice>& tmpDev : tmpDevs) {
+		std::shared_lock<std::shared_mutex> Lock(tmpDev->mutex);
+		if (recalc) memoryUsage += tmpDev->getSize();
+		else memoryUsage += tmpDev->getUsed();
+	}
 	return memoryUsage;
 }
 
+bool FFINKernelFSRoot::getCachedChunk(CodersFileSystem::Path path, const std::string& source, std::string& outChunk) {
+	CodersFileSystem::Path pending;
+	CodersFileSystem::SRef<CodersFileSystem::Device> device = getDevice(path, pending);
+	if (!device.isValid()) return false;
+	return FFINKernelFSChunkCache::Get().get(device, pending, source, outChunk);
+}
+
+void FFINKernelFSRoot::putCachedChunk(CodersFileSystem::Path path, const std::string& source, std::string chunk) {
+	CodersFileSystem::Path pending;
+	CodersFileSystem::SRef<CodersFileSystem::Device> device = getDevice(path, pending);
+	if (!device.isValid()) return;
+	FFINKernelFSChunkCache::Get().put(device, pending, source, std::move(chunk));
+}
+
 CodersFileSystem::WRef<FFINKernelFSDevDevice> FFINKernelFSRoot::getDevDevice() {
+	std::shared_lock<std::shared_mutex> Lock(mountsMutex);
 	for (auto& mount : mounts) {
 		if (FFINKernelFSDevDevice* device = dynamic_cast<FFINKernelFSDevDevice*>(mount.second.first.get())) return device;
 	}
@@ -54,6 +80,7 @@ CodersFileSystem::WRef<FFINKernelFSDevDevice> FFINKernelFSRoot::getDevDevice() {
 }
 
 CodersFileSystem::Path FFINKernelFSRoot::getMountPoint(CodersFileSystem::SRef<FFINKernelFSDevDevice> device) {
+	std::shared_lock<std::shared_mutex> Lock(mountsMutex);
 	for (auto& mount : mounts) {
 		if (device == mount.second.first) return mount.first;
 	}
@@ -89,6 +116,7 @@ CodersFileSystem::Path FFINKernelFSRoot::unpersistPath(std::string path) {
 			break;
 		}
 	}
+	std::shared_lock<std::shared_mutex> Lock(mountsMutex);
 	if (dev.isValid()) for (auto& mount : mounts) {
 		if (mount.second.first == dev) {
 			return mount.first / pending;
@@ -111,6 +139,7 @@ bool FFINKernelFSRoot::checkUnpersistPath(std::string path) {
 			break;
 		}
 	}
+	std::shared_lock<std::shared_mutex> Lock(mountsMutex);
 	if (dev.isValid()) for (auto& mount : mounts) {
 		if (mount.second.first == dev) {
 			return true;
@@ -120,10 +149,12 @@ bool FFINKernelFSRoot::checkUnpersistPath(std::string path) {
 }
 
 void FFINKernelFSRoot::Serialize(FStructuredArchive::FRecord Record, FFileSystemSerializationInfo& info) {
-	if (Record.GetUnderlyingArchive().IsSaving() && getDevDevice()) {
+	CodersFileSystem::SRef<FFINKernelFSDevDevice> devDev = getDevDevice();
+	if (Record.GetUnderlyingArchive().IsSaving() && devDev) {
 		// serialize mount points
+		std::shared_lock<std::shared_mutex> Lock(mountsMutex);
 		for (auto mount : mounts) {
-			for (auto device : getDevDevice()->getDevices()) {
+			for (auto device : devDev->getDevices()) {
 				if (mount.second.first == device.second) {
 					info.Mounts.Add(device.first.c_str(), mount.first.str().c_str());
 					break;
@@ -131,8 +162,10 @@ void FFINKernelFSRoot::Serialize(FStructuredArchive::FRecord Record, FFileSystem
 			}
 		}
 
+		Lock.unlock();
+
 		// serialize temp-fs
-		for (std::pair<const std::string, CodersFileSystem::SRef<CodersFileSystem::Device>> dev : getDevDevice()->getDevices()) {
+		for (std::pair<const std::string, CodersFileSystem::SRef<CodersFileSystem::Device>> dev : devDev->getDevices()) {
 			if (!dynamic_cast<CodersFileSystem::MemDevice*>(dev.second.get())) continue;
 			FFileSystemNode node = FFileSystemNode().Serialize(dev.second, "/");
 			node.NodeType = 3;
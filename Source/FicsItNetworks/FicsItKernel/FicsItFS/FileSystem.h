@@ -2,6 +2,7 @@
 
 #include "Library/FileSystemRoot.h"
 #include "DevDevice.h"
+#include "ChunkCache.h"
 #include "FileSystemSerializationInfo.h"
 
 class FArchive;
@@ -11,6 +12,7 @@ class FArchive;
  * - a central memory usage calculation
  * - preventing DevDevices to get unmounted
  * - preventing a second DevDevice to get mounted
+ * - access to the process wide cache of compiled Lua chunks
  */
 class FICSITNETWORKS_API FFINKernelFSRoot : public CodersFileSystem::FileSystemRoot {
 public:
@@ -35,6 +37,25 @@ public:
 	*/
 	std::int64_t getMemoryUsage(bool recalc = false);
 
+	/**
+	 * Looks up the compiled Lua chunk of the file at the given path in the chunk cache.
+	 *
+	 * @param[in]	path		the path of the file
+	 * @param[in]	source		the current content of the file
+	 * @param[out]	outChunk	the compiled chunk if it was found
+	 * @return	true if a chunk compiled from exactly the given source was found
+	 */
+	bool getCachedChunk(CodersFileSystem::Path path, const std::string& source, std::string& outChunk);
+
+	/**
+	 * Stores the compiled Lua chunk of the file at the given path in the chunk cache.
+	 *
+	 * @param[in]	path	the path of the file
+	 * @param[in]	source	the content of the file the chunk got compiled from
+	 * @param[in]	chunk	the compiled chunk
+	 */
+	void putCachedChunk(CodersFileSystem::Path path, const std::string& source, std::string chunk);
+
 	/**
 	 * Searchs in all mounts for a DevDevice mount
 	 *
@@ -3,6 +3,7 @@
 #include <iostream>
 
 #include "FileSystemRoot.h"
+#include "DiskMappedFileStream.h"
 
 using namespace std;
 namespace fs = std::filesystem;
@@ -142,41 +143,116 @@ namespace CodersFileSystem {
 		return {};
 	}
 
-	size_t getSizeFromPath(fs::path e) {
+	size_t getSizeFromPath(const fs::path& e) {
 		std::uint64_t count = 0;
-		if (fs::is_directory(e)) {
+		std::error_code error;
+		if (fs::is_directory(e, error)) {
 			count += e.filename().string().length();
-			for (auto& i : fs::directory_iterator(e)) {
+			for (const auto& i : fs::directory_iterator(e, error)) {
 				count += getSizeFromPath(i);
 			}
-		} else if (fs::is_regular_file(e)) {
+		} else if (fs::is_regular_file(e, error)) {
 			count += e.filename().string().length();
-			count += fs::file_size(e);
+			std::uintmax_t fileSize = fs::file_size(e, error);
+			if (!error) count += fileSize;
 		}
 		return count;
 	}
 
 	size_t DiskDevice::getSize() const {
-		return getSizeFromPath(realPath);
+		std::lock_guard<std::recursive_mutex> lock(watcherMutex);
+		// without watcher the tracked sizes can't be kept up to date
+		if (!watcher.isActive()) return getSizeFromPath(realPath);
+		return trackedSize;
+	}
+
+	void DiskDevice::untrackNode(const std::string& path) {
+		auto node = nodeSizes.find(path);
+		if (node == nodeSizes.end()) return;
+		trackedSize -= node->second;
+		nodeSizes.erase(node);
+		std::string prefix = path + "/";
+		for (auto child = nodeSizes.lower_bound(prefix); child != nodeSizes.end() && child->first.compare(0, prefix.length(), prefix) == 0;) {
+			trackedSize -= child->second;
+			child = nodeSizes.erase(child);
+		}
+	}
+
+	void DiskDevice::trackNode(const std::string& path) {
+		untrackNode(path);
+		fs::path spath = realPath / path;
+		std::error_code error;
+		size_t size = spath.filename().string().length();
+		if (fs::is_directory(spath, error)) {
+			for (const auto& entry : fs::directory_iterator(spath, error)) {
+				trackNode(path + "/" + entry.path().filename().string());
+			}
+		} else if (fs::is_regular_file(spath, error)) {
+			std::uintmax_t fileSize = fs::file_size(spath, error);
+			if (!error) size += fileSize;
+		} else return;
+		nodeSizes[path] = size;
+		trackedSize += size;
+	}
+
+	void DiskDevice::invalidateNode(const std::string& path) {
+		std::lock_guard<std::recursive_mutex> lock(watcherMutex);
+		const std::string prefix = path.empty() ? path : path + "/";
+		nodeCache.erase(path);
+		for (auto child = nodeCache.lower_bound(prefix); child != nodeCache.end() && child->first.compare(0, prefix.length(), prefix) == 0;) {
+			child = nodeCache.erase(child);
+		}
+		childsCache.erase(path);
+		for (auto child = childsCache.lower_bound(prefix); child != childsCache.end() && child->first.compare(0, prefix.length(), prefix) == 0;) {
+			child = childsCache.erase(child);
+		}
+		const size_t slash = path.find_last_of('/');
+		childsCache.erase(slash == std::string::npos ? "" : path.substr(0, slash));
+	}
+
+	void DiskDevice::trackAll() {
+		nodeSizes.clear();
+		trackedSize = realPath.filename().string().length();
+		std::error_code error;
+		for (const auto& entry : fs::directory_iterator(realPath, error)) {
+			trackNode(entry.path().filename().string());
+		}
 	}
 
 	DiskDevice::DiskDevice(fs::path realPath, size_t capacity) : ByteCountedDevice(capacity), realPath(realPath), watcher(realPath,
 		[&](int eventType, auto node, auto to, auto from) {
+			// keep the tracked sizes and node cache up to date, so getting the used space doesn't need to scan the whole device
 			switch (eventType) {
 			case 0:
+				trackNode(to.relative().str());
+				invalidateNode(to.relative().str());
 				listeners.onNodeAdded(to, node);
 				break;
 			case 1:
+				untrackNode(to.relative().str());
+				invalidateNode(to.relative().str());
 				listeners.onNodeRemoved(to, node);
 				break;
 			case 2:
+				if (node == NT_File) trackNode(to.relative().str());
 				listeners.onNodeChanged(to, node);
 				break;
 			case 3:
+				untrackNode(from.relative().str());
+				trackNode(to.relative().str());
+				invalidateNode(from.relative().str());
+				invalidateNode(to.relative().str());
 				listeners.onNodeRenamed(to, from, node);
 				break;
+			case 4:
+				if (watcher.isActive()) trackAll();
+				nodeCache.clear();
+				childsCache.clear();
+				listeners.onNodeChanged(Path(), NT_Directory);
+				break;
 			}
 		}) {
+		if (watcher.isActive()) trackAll();
 		getUsed();
 	}
 
@@ -184,7 +260,13 @@ namespace CodersFileSystem {
 		std::filesystem::path spath = realPath / path.relative().str();
 		if (fs::exists(spath) && !fs::is_regular_file(spath)) return nullptr;
 		else if (!fs::is_directory(spath / "..")) return nullptr;
-		return new DiskFileStream(spath, mode, checkSize);
+		if (mode & FileMode::MAPPED) {
+			SRef<FileStream> mapped = new DiskMappedFileStream(spath, mode);
+			if (mapped->isOpen()) return mapped;
+		}
+		SRef<FileStream> stream = new DiskFileStream(spath, mode, checkSize);
+		if (mode & FileMode::OUTPUT) invalidateNode(path.relative().str());
+		return stream;
 	}
 
 	SRef<Directory> DiskDevice::createDir(Path path, bool createTree) {
@@ -199,7 +281,8 @@ namespace CodersFileSystem {
 		} else if (fs::is_directory(spath / "..")) {
 			fs::create_directory(spath);
 		} else return nullptr;
-		tickWatcher();
+		invalidateNode(path.relative().str());
+		tickWatcherLocked();
 		return get(path);
 	}
 
@@ -207,9 +290,12 @@ namespace CodersFileSystem {
 		if (path.isEmpty()) return false;
 		std::filesystem::path spath = realPath / path.relative().str();
 		try {
-			if (recursive) return fs::remove_all(spath) > 0;
-			else return fs::remove(spath);
-			tickWatcher();
+			bool removed;
+			if (recursive) removed = fs::remove_all(spath) > 0;
+			else removed = fs::remove(spath);
+			invalidateNode(path.relative().str());
+			tickWatcherLocked();
+			return removed;
 		} catch (...) {
 			return false;
 		}
@@ -221,34 +307,69 @@ namespace CodersFileSystem {
 		std::filesystem::path spath = realPath / path.str();
 		if (!fs::exists(spath) || fs::exists(realPath / (path / ".." / name).str()) || path.isRoot()) return false;
 		fs::rename(spath, realPath / (path / ".." / name).str());
-		tickWatcher();
+		invalidateNode(path.str());
+		invalidateNode((path / ".." / name).relative().str());
+		tickWatcherLocked();
 		return true;
 	}
 
 	SRef<Node> DiskDevice::get(Path path) {
 		path = path.normalize();
 		if (path.isEmpty()) return new DiskDirectory(realPath, checkSize);
-		std::filesystem::path spath = realPath / path.relative().str();
+		const std::string relPath = path.relative().str();
+		{
+			std::lock_guard<std::recursive_mutex> lock(watcherMutex);
+			auto cached = nodeCache.find(relPath);
+			if (cached != nodeCache.end()) {
+				++nodeCacheHits;
+				return cached->second;
+			}
+		}
+		++nodeCacheMisses;
+		std::filesystem::path spath = realPath / relPath;
+		SRef<Node> node;
 		if (fs::is_regular_file(spath)) {
-			return new DiskFile(spath, checkSize);
+			node = new DiskFile(spath, checkSize);
 		} else if (fs::is_directory(spath)) {
-			return new DiskDirectory(spath, checkSize);
+			node = new DiskDirectory(spath, checkSize);
 		}
-		return nullptr;
+		std::lock_guard<std::recursive_mutex> lock(watcherMutex);
+		// without watcher external changes would go unnoticed, so only cache while it is active
+		if (watcher.isActive()) nodeCache[relPath] = node;
+		return node;
 	}
 
 	unordered_set<std::string> DiskDevice::childs(Path path) {
+		path = path.normalize();
+		const std::string relPath = path.relative().str();
+		{
+			std::lock_guard<std::recursive_mutex> lock(watcherMutex);
+			auto cached = childsCache.find(relPath);
+			if (cached != childsCache.end()) {
+				++nodeCacheHits;
+				return cached->second;
+			}
+		}
+		++nodeCacheMisses;
 		std::unordered_set<std::string> childs;
-		std::filesystem::path spath = realPath / path.relative().str();
+		std::filesystem::path spath = realPath / relPath;
 		std::filesystem::path NewPath = spath;
 		for (const auto& entry : fs::directory_iterator(NewPath)) {
 			std::string childName = entry.path().filename().string();
 			childs.insert(childName);
 		}
+		std::lock_guard<std::recursive_mutex> lock(watcherMutex);
+		if (watcher.isActive()) childsCache[relPath] = childs;
 		return childs;
 	}
 
 	void DiskDevice::tickWatcher() {
+		std::unique_lock<std::shared_mutex> deviceLock(mutex);
+		tickWatcherLocked();
+	}
+
+	void DiskDevice::tickWatcherLocked() {
+		std::lock_guard<std::recursive_mutex> lock(watcherMutex);
 		watcher.tick();
 	}
 
@@ -256,6 +377,14 @@ namespace CodersFileSystem {
 		return realPath;
 	}
 
+	std::uint64_t DiskDevice::getNodeCacheHits() const {
+		return nodeCacheHits;
+	}
+
+	std::uint64_t DiskDevice::getNodeCacheMisses() const {
+		return nodeCacheMisses;
+	}
+
 	DeviceNode::DeviceNode(SRef<Device> device) : device(device) {}
 
 	SRef<FileStream> DeviceNode::open(FileMode mode) {
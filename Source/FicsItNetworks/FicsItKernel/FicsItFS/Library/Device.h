@@ -4,7 +4,13 @@
 #include "Directory.h"
 #include "Listener.h"
 #include "WindowsFileWatcher.h"
+#include "LinuxFileWatcher.h"
+#include "NullFileWatcher.h"
 
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_set>
 
 namespace CodersFileSystem {
@@ -17,6 +23,12 @@ namespace CodersFileSystem {
 		ListenerList listeners;
 
 	public:
+		/**
+		 * Guards the nodes of this device against concurrent access through the file system root.
+		 * Reading operations lock it shared, operations changing the nodes lock it exclusively.
+		 */
+		std::shared_mutex mutex;
+		
 		virtual ~Device() {}
 
 		/*
@@ -150,10 +162,61 @@ namespace CodersFileSystem {
 
 	struct DiskDeviceWatcher;
 
+#if PLATFORM_WINDOWS
+	typedef WindowsFileWatcher FileWatcher;
+#elif PLATFORM_LINUX
+	typedef LinuxFileWatcher FileWatcher;
+#else
+	typedef NullFileWatcher FileWatcher;
+#endif
+
 	class DiskDevice : public ByteCountedDevice {
 	private:
 		std::filesystem::path realPath;
-		WindowsFileWatcher watcher;
+		FileWatcher watcher;
+		mutable std::recursive_mutex watcherMutex;
+
+		/**
+		 * The counted size of every node in the device by relative path, kept up to date by the watcher events.
+		 * Only used while the watcher is active, otherwise the size gets scanned from the real file system.
+		 */
+		std::map<std::string, size_t> nodeSizes;
+		size_t trackedSize = 0;
+
+		/**
+		 * The looked up nodes (nullptr if the node doesn't exist) and child lists by relative path,
+		 * invalidated by the watcher events and the changes made through the device, so lookups only stat on a miss.
+		 * Only used while the watcher is active.
+		 */
+		std::map<std::string, SRef<Node>> nodeCache;
+		std::map<std::string, std::unordered_set<std::string>> childsCache;
+		std::atomic<std::uint64_t> nodeCacheHits = 0;
+		std::atomic<std::uint64_t> nodeCacheMisses = 0;
+
+		/**
+		 * Removes the cached lookups of the given node, all its children and the child list of its parent
+		 */
+		void invalidateNode(const std::string& path);
+
+		/**
+		 * Removes the given node and all its children from the tracked sizes
+		 */
+		void untrackNode(const std::string& path);
+
+		/**
+		 * Reads the size of the given node, and of all its children if it is a directory, into the tracked sizes
+		 */
+		void trackNode(const std::string& path);
+
+		/**
+		 * Rebuilds the tracked sizes from a full scan of the device
+		 */
+		void trackAll();
+
+		/**
+		 * Ticks the watcher, expects the device to be already locked
+		 */
+		void tickWatcherLocked();
 
 	protected:
 		virtual size_t getSize() const override;
@@ -170,6 +233,7 @@ namespace CodersFileSystem {
 
 		/*
 		* calls all event changes since device creation or last call
+		* locks the device exclusively, as the events change the node sizes and notify the listeners
 		*/
 		void tickWatcher();
 
@@ -179,6 +243,16 @@ namespace CodersFileSystem {
 		 * @return the real path mapped
 		 */
 		std::filesystem::path getRealPath() const;
+
+		/**
+		 * Returns the amount of node and child list lookups served by the node cache
+		 */
+		std::uint64_t getNodeCacheHits() const;
+
+		/**
+		 * Returns the amount of node and child list lookups that had to query the real file system
+		 */
+		std::uint64_t getNodeCacheMisses() const;
 	};
 
 	class DeviceNode : public Node {
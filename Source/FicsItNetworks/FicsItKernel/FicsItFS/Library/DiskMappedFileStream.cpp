@@ -0,0 +1,168 @@
+#include "DiskMappedFileStream.h"
+
+#include "CoreMinimal.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#if PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include "Windows.h"
+#endif
+
+using namespace CodersFileSystem;
+
+// the open mappings by real file path, so writers can close them before the file gets truncated
+static std::mutex mappingsMutex;
+static std::unordered_map<std::string, std::unordered_set<DiskMappedFileStream*>> mappings;
+
+static std::string getMappingKey(const std::filesystem::path& realPath) {
+	return realPath.lexically_normal().generic_string();
+}
+
+DiskMappedFileStream::DiskMappedFileStream(const std::filesystem::path& realPath, FileMode mode) : FileStream(mode) {
+	if (!(mode & FileMode::INPUT) || (mode & (FileMode::OUTPUT | FileMode::APPEND | FileMode::TRUNC))) return;
+#if PLATFORM_LINUX
+	int fd = ::open(realPath.c_str(), O_RDONLY);
+	if (fd < 0) return;
+	struct stat info;
+	if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+		length = info.st_size;
+		if (length < 1) {
+			open = true;
+		} else {
+			void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping != MAP_FAILED) {
+				data = static_cast<const char*>(mapping);
+				open = true;
+			}
+		}
+	}
+	::close(fd);
+#elif PLATFORM_WINDOWS
+	HANDLE file = CreateFileW(realPath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return;
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(file, &size)) {
+		length = size.QuadPart;
+		if (length < 1) {
+			open = true;
+		} else {
+			// the view keeps the mapping alive, so both handles can get closed right away
+			HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping) {
+				data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				open = data != nullptr;
+				CloseHandle(mapping);
+			}
+		}
+	}
+	CloseHandle(file);
+#endif
+	if (!open) {
+		length = 0;
+		return;
+	}
+	mappingKey = getMappingKey(realPath);
+	std::lock_guard<std::mutex> lock(mappingsMutex);
+	mappings[mappingKey].insert(this);
+}
+
+DiskMappedFileStream::~DiskMappedFileStream() {
+	close();
+}
+
+void DiskMappedFileStream::unregister() {
+	if (mappingKey.empty()) return;
+	std::lock_guard<std::mutex> lock(mappingsMutex);
+	auto streams = mappings.find(mappingKey);
+	if (streams == mappings.end()) return;
+	streams->second.erase(this);
+	if (streams->second.empty()) mappings.erase(streams);
+}
+
+void DiskMappedFileStream::closeMappings(const std::filesystem::path& realPath) {
+	// the streams only lock the mappings after releasing their own lock, so they can't get destroyed while being closed here
+	std::lock_guard<std::mutex> lock(mappingsMutex);
+	auto streams = mappings.find(getMappingKey(realPath));
+	if (streams == mappings.end()) return;
+	for (DiskMappedFileStream* stream : streams->second) {
+		std::lock_guard<std::mutex> streamLock(stream->mutex);
+		if (stream->open) {
+			stream->unmap();
+			stream->open = false;
+		}
+	}
+	mappings.erase(streams);
+}
+
+void DiskMappedFileStream::unmap() {
+	if (data) {
+#if PLATFORM_LINUX
+		munmap(const_cast<char*>(data), length);
+#elif PLATFORM_WINDOWS
+		UnmapViewOfFile(data);
+#endif
+	}
+	data = nullptr;
+	length = 0;
+	pos = 0;
+}
+
+void DiskMappedFileStream::write(std::string_view str) {
+	throw std::exception("filestream not in output mode");
+}
+
+size_t DiskMappedFileStream::read(char* buffer, size_t chars) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!open) throw std::exception("filestream not open");
+	if (pos >= length) {
+		flagEOF = true;
+		return 0;
+	}
+	flagEOF = false;
+	const size_t count = std::min(chars, length - pos);
+	memcpy(buffer, data + pos, count);
+	pos += count;
+	return count;
+}
+
+bool DiskMappedFileStream::isEOF() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return flagEOF;
+}
+
+std::int64_t DiskMappedFileStream::seek(std::string w, std::int64_t off) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!open) throw std::exception("filestream not open");
+	flagEOF = false;
+	std::int64_t newPos;
+	if (w == "set") newPos = off;
+	else if (w == "cur") newPos = pos + off;
+	else if (w == "end") newPos = length + off;
+	else throw std::exception("no valid whence");
+	pos = std::clamp<std::int64_t>(newPos, 0, length);
+	return pos;
+}
+
+void DiskMappedFileStream::close() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (open) {
+			unmap();
+			open = false;
+		}
+	}
+	unregister();
+}
+
+bool DiskMappedFileStream::isOpen() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return open;
+}
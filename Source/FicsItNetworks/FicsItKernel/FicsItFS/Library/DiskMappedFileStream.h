@@ -0,0 +1,65 @@
+#pragma once
+
+#include "File.h"
+
+#include <filesystem>
+#include <mutex>
+#include <string>
+
+namespace CodersFileSystem {
+	/**
+	 * Read-only file stream backed by a memory mapping of the whole file,
+	 * reads and seeks are direct slices of the mapping instead of going through a fstream.
+	 * Reading from a mapping of a truncated file crashes, so every DiskFileStream writing to a file closes its mappings first.
+	 * Changes made outside of the game still must not truncate a mapped file.
+	 * Closing unmaps the file and is safe to call from listeners while another thread reads,
+	 * as every operation holds the lock of the stream.
+	 */
+	class DiskMappedFileStream : public FileStream {
+	protected:
+		const char* data = nullptr;
+		size_t length = 0;
+		size_t pos = 0;
+		bool open = false;
+		bool flagEOF = false;
+		std::mutex mutex;
+		std::string mappingKey;
+
+		/**
+		 * Unmaps the file, expects the stream to be already locked
+		 */
+		void unmap();
+
+		/**
+		 * Removes the stream from the open mappings, expects the stream to be not locked
+		 */
+		void unregister();
+
+	public:
+		/**
+		 * Maps the file at the given path, the stream is not open if the file could not get mapped
+		 * or if the platform doesn't support mappings, so the caller can fall back to a DiskFileStream.
+		 *
+		 * @param[in]	realPath	the path to the file you want to map
+		 * @param[in]	mode		the mode of the stream, has to be input only
+		 */
+		DiskMappedFileStream(const std::filesystem::path& realPath, FileMode mode);
+		~DiskMappedFileStream();
+
+		using FileStream::read;
+		virtual void write(std::string_view str) override;
+		virtual size_t read(char* buffer, size_t chars) override;
+		virtual bool isEOF() override;
+		virtual std::int64_t seek(std::string w, std::int64_t off) override;
+		virtual void close() override;
+		virtual bool isOpen() override;
+
+		/**
+		 * Closes every mapped stream of the given file, has to be called before the file gets truncated.
+		 * Reads from the closed streams fail like from any other closed stream.
+		 *
+		 * @param[in]	realPath	the path to the file which is about to get written
+		 */
+		static void closeMappings(const std::filesystem::path& realPath);
+	};
+}
@@ -1,4 +1,5 @@
 #include "File.h"
+#include "DiskMappedFileStream.h"
 
 #include <filesystem>
 
@@ -37,7 +38,45 @@ bool CodersFileSystem::MemFile::isValid() const {
 }
 
 size_t MemFile::getSize() const {
-	return data.length();
+	return data.size();
+}
+
+size_t MemFileData::size() const {
+	return length;
+}
+
+void MemFileData::write(size_t pos, const char* src, size_t len) {
+	size_t end = pos + len;
+	while (pages.size() * PageSize < end) pages.push_back(std::make_unique<char[]>(PageSize));
+	while (len > 0) {
+		size_t offset = pos % PageSize;
+		size_t count = std::min(len, PageSize - offset);
+		memcpy(pages[pos / PageSize].get() + offset, src, count);
+		pos += count;
+		src += count;
+		len -= count;
+	}
+	if (end > length) length = end;
+}
+
+size_t MemFileData::read(size_t pos, char* dst, size_t len) const {
+	if (pos >= length) return 0;
+	len = std::min(len, length - pos);
+	size_t read = len;
+	while (len > 0) {
+		size_t offset = pos % PageSize;
+		size_t count = std::min(len, PageSize - offset);
+		memcpy(dst, pages[pos / PageSize].get() + offset, count);
+		pos += count;
+		dst += count;
+		len -= count;
+	}
+	return read;
+}
+
+void MemFileData::clear() {
+	pages.clear();
+	length = 0;
 }
 
 FileStream::FileStream(FileMode mode) : mode(mode) {}
@@ -52,17 +91,38 @@ FileStream& FileStream::operator<<(const std::string& str) {
 	return *this;
 }
 
+std::string FileStream::read(size_t chars) {
+	std::string str;
+	str.resize(chars);
+	str.resize(read(str.data(), chars));
+	return str;
+}
+
+std::int64_t FileStream::getRemaining() {
+	const std::int64_t pos = seek("cur", 0);
+	const std::int64_t end = seek("end", 0);
+	seek("set", pos);
+	return std::max<std::int64_t>(end - pos, 0);
+}
+
 std::string FileStream::readAll(SRef<FileStream> stream) {
 	std::string str;
+	str.resize(stream->getRemaining());
+	size_t length = 0;
 	do {
-		str.append(stream->read(1024));
+		if (str.size() - length < 1024) str.resize(length + 1024);
+		length += stream->read(str.data() + length, str.size() - length);
 	} while (!stream->isEOF());
+	str.resize(length);
 	return str;
 }
 
-MemFileStream::MemFileStream(string * data, FileMode mode, ListenerListRef& listeners, SizeCheckFunc sizeCheck) : FileStream(mode), data(data), listeners(listeners), sizeCheck(sizeCheck) {
-	if ((mode & CodersFileSystem::OUTPUT) && (mode & CodersFileSystem::APPEND)) pos = data->length();
-	else if (mode & CodersFileSystem::TRUNC) *data = "";
+MemFileStream::MemFileStream(MemFileData* data, FileMode mode, ListenerListRef& listeners, SizeCheckFunc sizeCheck) : FileStream(mode), data(data), listeners(listeners), sizeCheck(sizeCheck) {
+	if ((mode & CodersFileSystem::OUTPUT) && (mode & CodersFileSystem::APPEND)) pos = data->size();
+	else if (mode & CodersFileSystem::TRUNC) {
+		sizeCheck(-static_cast<int64_t>(data->size()), true);
+		data->clear();
+	}
 	open = true;
 }
 
@@ -70,25 +130,25 @@ MemFileStream::~MemFileStream() {
 	close();
 }
 
-void MemFileStream::write(string newData) {
+void MemFileStream::write(string_view newData) {
 	if (!isOpen()) throw std::exception("filestream not open");
-	if (!sizeCheck(data->length(), true)) throw std::exception("out of memory");
-	data->erase(pos, newData.length());
-	data->insert(pos, newData);
-	pos += newData.length();
+	uint64_t end = pos + newData.length();
+	if (end > data->size() && !sizeCheck(end - data->size(), true)) throw std::exception("out of memory");
+	data->write(pos, newData.data(), newData.length());
+	pos = end;
 }
 
-string MemFileStream::read(size_t chars) {
+size_t MemFileStream::read(char* buffer, size_t chars) {
 	if (!isOpen()) throw std::exception("filestream not open");
 	if (!(mode & FileMode::INPUT)) throw std::exception("filestream not in input mode");
 	if (pos >= data->size()) {
 		flagEOF = true;
-		return "";
+		return 0;
 	}
 	flagEOF = false;
-	string buf = data->substr(pos, chars);
-	pos += buf.length();
-	return buf;
+	size_t count = data->read(pos, buffer, std::min<uint64_t>(chars, data->size() - pos));
+	pos += count;
+	return count;
 }
 
 bool MemFileStream::isEOF() {
@@ -101,9 +161,9 @@ int64_t MemFileStream::seek(string str, int64_t off) {
 	if (mode & APPEND) return pos;
 	if (str == "set") pos = off;
 	else if (str == "cur") pos += off;
-	else if (str == "end") pos = data->length() + off;
+	else if (str == "end") pos = data->size() + off;
 	else throw exception("no valid whence");
-	if (pos > static_cast<uint64_t>(data->length())) pos = data->length();
+	if (pos > static_cast<uint64_t>(data->size())) pos = data->size();
 	else if (pos < 0) pos = 0;
 	return pos;
 }
@@ -121,6 +181,10 @@ bool MemFileStream::isOpen() {
 DiskFile::DiskFile(const filesystem::path& realPath, SizeCheckFunc sizeCheck) : File(), realPath(realPath), sizeCheck(sizeCheck) {}
 
 SRef<FileStream> DiskFile::open(FileMode m) {
+	if (m & FileMode::MAPPED) {
+		SRef<FileStream> mapped = new DiskMappedFileStream(realPath, m);
+		if (mapped->isOpen()) return mapped;
+	}
 	SRef<FileStream> s = new DiskFileStream(realPath, m, sizeCheck);
 	if (s->isOpen()) return s;
 	return nullptr;
@@ -134,6 +198,8 @@ DiskFileStream::DiskFileStream(filesystem::path realPath, FileMode mode, SizeChe
 	if (!(mode & (FileMode::OUTPUT | FileMode::INPUT))) {
 		throw std::exception("I/O mode not set");
 	}
+	// writing may truncate the file, which would crash reads of its mappings
+	if (mode & (FileMode::OUTPUT | FileMode::TRUNC)) DiskMappedFileStream::closeMappings(realPath);
 	if ((mode & FileMode::TRUNC) && filesystem::exists(realPath)) {
 		sizeCheck(-static_cast<int64_t>(std::filesystem::file_size(realPath)), true);
 	}
@@ -149,23 +215,18 @@ DiskFileStream::DiskFileStream(filesystem::path realPath, FileMode mode, SizeChe
 
 DiskFileStream::~DiskFileStream() {}
 
-void DiskFileStream::write(string data) {
+void DiskFileStream::write(string_view data) {
 	if (!isOpen()) throw std::exception("filestream not open");
 	if (!sizeCheck(data.length(), true)) throw std::exception("out of capacity");
-	stream << data;
+	stream.write(data.data(), data.length());
 	stream.flush();
 }
 
-string DiskFileStream::read(size_t chars) {
+size_t DiskFileStream::read(char* buffer, size_t chars) {
 	if (!isOpen()) throw std::exception("filestream not open");
 	if (!(mode & FileMode::INPUT)) throw std::exception("filestream not in input mode");
-	string s;
-	// Ensure buffer is large enough to hold characters.
-	s.resize(chars);
-	stream.read(const_cast<char*>(s.data()), chars);
-	// Shrink the string to the actual number of characters we read.
-	s.resize(stream.gcount());
-	return s;
+	stream.read(buffer, chars);
+	return stream.gcount();
 }
 
 bool DiskFileStream::isEOF() {
@@ -6,6 +6,9 @@
 #include "FileSystem.h"
 #include <sstream>
 #include <fstream>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 namespace CodersFileSystem {
 	class MemFileStream;
@@ -18,6 +21,7 @@ namespace CodersFileSystem {
 		APPEND	= 0b00100,
 		TRUNC	= 0b01000,
 		BINARY	= 0b10000,
+		MAPPED	= 0b100000, // input only streams of disk files read from a memory mapping if possible
 	};
 
 	FileMode operator |(FileMode l, FileMode r);
@@ -31,9 +35,55 @@ namespace CodersFileSystem {
 		virtual std::unordered_set<std::string> getChilds() const override;
 	};
 
+	/**
+	 * The content of a memory file, stored in fixed size pages
+	 * so writes and reads only touch the bytes they actually access.
+	 */
+	class MemFileData {
+	public:
+		static constexpr size_t PageSize = 4096;
+
+	private:
+		std::vector<std::unique_ptr<char[]>> pages;
+		size_t length = 0;
+
+	public:
+		/*
+		 * returns the amount of bytes stored
+		 *
+		 * @return	size of the content
+		 */
+		size_t size() const;
+
+		/*
+		 * Overwrites the content at the given position with the given data,
+		 * extends the content if the data reaches past the end.
+		 *
+		 * @param[in]	pos		the position to write at, has to be less or equal to the size
+		 * @param[in]	src		the data to write
+		 * @param[in]	len		the amount of bytes to write
+		 */
+		void write(size_t pos, const char* src, size_t len);
+
+		/*
+		 * Copies the content at the given position into the given buffer
+		 *
+		 * @param[in]	pos		the position to read from
+		 * @param[out]	dst		the buffer to read into
+		 * @param[in]	len		the maximum amount of bytes to read
+		 * @return	the amount of bytes actually read
+		 */
+		size_t read(size_t pos, char* dst, size_t len) const;
+
+		/*
+		 * Removes all content and frees the pages
+		 */
+		void clear();
+	};
+
 	class MemFile : public File {
 	private:
-		std::string data;
+		MemFileData data;
 		WRef<MemFileStream> io;
 		ListenerListRef listeners;
 		SizeCheckFunc sizeCheck;
@@ -83,18 +133,37 @@ namespace CodersFileSystem {
 		*
 		* @param[in]	str	the string you want to write to the stream
 		*/
-		virtual void write(std::string str) = 0;
+		virtual void write(std::string_view str) = 0;
 
 		/*
-		 * reads the given amount of characters of the input-stream at the current input-stream pos.
-		 * might return less characters than requested, but stream may still have characters available later.
+		 * reads up to the given amount of characters of the input-stream at the current input-stream pos into the given buffer.
+		 * might read less characters than requested, but stream may still have characters available later.
 		 *
 		 * If no further characters are available in filestream, EOF flag will be set and can be checked with the isEOF function.
 		 *
+		 * @param[out]	buffer	the buffer the read chars get written to, has to be able to hold the given count of chars
+		 * @param[in]	chars	the count of chars you want to read
+		 * @return	the count of chars actually read
+		 */
+		virtual size_t read(char* buffer, size_t chars) = 0;
+
+		/*
+		 * reads the given amount of characters of the input-stream at the current input-stream pos.
+		 * same as reading into a buffer, but returns the read chars as string.
+		 *
 		 * @param[in]	chars	the count of chars you want to read
 		 * @return	the read chars as string
 		 */
-		virtual std::string read(size_t chars) = 0;
+		std::string read(size_t chars);
+
+		/**
+		 * Returns the count of chars between the input-stream pos and the end of the stream,
+		 * so bulk reads can allocate their buffer upfront.
+		 * Is 0 if the stream doesn't know its size, so reading till EOF is still required.
+		 *
+		 * @return	the count of chars remaining in the stream
+		 */
+		std::int64_t getRemaining();
 
 		/**
 		 * Returns true if the end-of-file (EOF) flag was set.
@@ -143,7 +212,7 @@ namespace CodersFileSystem {
 
 	class MemFileStream : public FileStream {
 	protected:
-		std::string* data;
+		MemFileData* data;
 		uint64_t pos = 0;
 		ListenerListRef& listeners;
 		SizeCheckFunc sizeCheck;
@@ -151,11 +220,12 @@ namespace CodersFileSystem {
 		bool flagEOF = false;
 
 	public:
-		MemFileStream(std::string* data, FileMode mode, ListenerListRef& listeners, SizeCheckFunc sizeCheck = [](auto, auto) { return true; });
+		MemFileStream(MemFileData* data, FileMode mode, ListenerListRef& listeners, SizeCheckFunc sizeCheck = [](auto, auto) { return true; });
 		~MemFileStream();
 
-		virtual void write(std::string str) override;
-		virtual std::string read(size_t chars) override;
+		using FileStream::read;
+		virtual void write(std::string_view str) override;
+		virtual size_t read(char* buffer, size_t chars) override;
 		virtual bool isEOF() override;
 		virtual std::int64_t seek(std::string w, std::int64_t off) override;
 		virtual void close() override;
@@ -172,8 +242,9 @@ namespace CodersFileSystem {
 		DiskFileStream(std::filesystem::path realPath, FileMode mode, SizeCheckFunc sizeCheck = [](auto, auto) { return true; });
 		~DiskFileStream();
 
-		virtual void write(std::string str) override;
-		virtual std::string read(size_t chars) override;
+		using FileStream::read;
+		virtual void write(std::string_view str) override;
+		virtual size_t read(char* buffer, size_t chars) override;
 		virtual bool isEOF() override;
 		virtual std::int64_t seek(std::string w, std::int64_t off) override;
 		virtual void close() override;
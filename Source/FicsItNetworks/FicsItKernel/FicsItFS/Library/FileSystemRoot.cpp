@@ -3,17 +3,56 @@
 using namespace CodersFileSystem;
 using namespace std;
 
+typedef std::shared_lock<std::shared_mutex> ReadLock;
+typedef std::unique_lock<std::shared_mutex> WriteLock;
+
 FileSystemException::FileSystemException(std::string what) : std::exception(what.c_str()) {}
 
+LockedFileStream::LockedFileStream(SRef<Device> device, SRef<FileStream> stream) : FileStream(stream->getMode()), device(device), stream(stream) {}
+
+void LockedFileStream::write(std::string_view str) {
+	WriteLock lock(device->mutex);
+	std::lock_guard<std::mutex> streamLock(streamMutex);
+	stream->write(str);
+}
+
+size_t LockedFileStream::read(char* buffer, size_t chars) {
+	ReadLock lock(device->mutex);
+	std::lock_guard<std::mutex> streamLock(streamMutex);
+	return stream->read(buffer, chars);
+}
+
+bool LockedFileStream::isEOF() {
+	std::lock_guard<std::mutex> streamLock(streamMutex);
+	return stream->isEOF();
+}
+
+std::int64_t LockedFileStream::seek(std::string w, std::int64_t off) {
+	ReadLock lock(device->mutex);
+	std::lock_guard<std::mutex> streamLock(streamMutex);
+	return stream->seek(w, off);
+}
+
+void LockedFileStream::close() {
+	// closing only changes the stream itself, and listeners close streams while the device is locked,
+	// so only the stream lock is taken
+	std::lock_guard<std::mutex> streamLock(streamMutex);
+	stream->close();
+}
+
+bool LockedFileStream::isOpen() {
+	std::lock_guard<std::mutex> streamLock(streamMutex);
+	return stream->isOpen();
+}
+
 SRef<Device> FileSystemRoot::getDevice(Path path, Path& pending) {
+	ReadLock lock(mountsMutex);
 	Path mountP = "";
 	path = path.absolute();
 	SRef<Device> mountD;
 	for (auto mount = mounts.begin(); mount != mounts.end(); mount++) {
-		if (!mount->second.first.isValid()) {
-			mounts.erase(mount--);
-			continue;
-		}
+		// invalid mounts get cleaned up on the next mount or unmount
+		if (!mount->second.first.isValid()) continue;
 		if (path.startsWith(mount->first) && mount->first.str().size() >= mountP.str().size()) {
 			mountP = mount->first;
 			mountD = mount->second.first;
@@ -49,7 +88,16 @@ SRef<FileStream> FileSystemRoot::open(Path path, FileMode mode) {
 	Path pending = "";
 	auto device = getDevice(path.absolute(), pending);
 	if (!device.isValid()) return nullptr;
-	return device->open(pending, mode);
+	SRef<FileStream> stream;
+	if (mode & (OUTPUT | APPEND | TRUNC)) {
+		WriteLock lock(device->mutex);
+		stream = device->open(pending, mode);
+	} else {
+		ReadLock lock(device->mutex);
+		stream = device->open(pending, mode);
+	}
+	if (!stream.isValid()) return nullptr;
+	return new LockedFileStream(device, stream);
 }
 
 SRef<Directory> FileSystemRoot::createDir(Path path, bool createTree) {
@@ -57,6 +105,7 @@ SRef<Directory> FileSystemRoot::createDir(Path path, bool createTree) {
 	path = path.absolute();
 	auto device = getDevice(path / "..", pending);
 	if (!device.isValid()) return nullptr;
+	WriteLock lock(device->mutex);
 	return device->createDir(pending / path.fileName(), createTree);
 }
 
@@ -65,8 +114,13 @@ bool FileSystemRoot::remove(Path path, bool recursive) {
 	path = path.absolute();
 	auto device = getDevice(path / "..", pending);
 	if (!device.isValid()) return false;
-	auto removed = device->remove(pending / path.fileName(), recursive);
+	bool removed;
+	{
+		WriteLock lock(device->mutex);
+		removed = device->remove(pending / path.fileName(), recursive);
+	}
 	if (removed) {
+		WriteLock lock(mountsMutex);
 		for (auto i = mounts.begin(); i != mounts.end(); i++) {
 			if (i->first.startsWith(path)) {
 				mounts.erase(i--);
@@ -82,8 +136,13 @@ bool FileSystemRoot::rename(Path path, const std::string& name) {
 	Path pending = "";
 	auto device = getDevice(path / "..", pending);
 	if (!device.isValid()) return false;
-	auto renamed = device->rename(pending / path.fileName(), name);
+	bool renamed;
+	{
+		WriteLock lock(device->mutex);
+		renamed = device->rename(pending / path.fileName(), name);
+	}
 	if (renamed) {
+		WriteLock lock(mountsMutex);
 		for (auto i = mounts.begin(); i != mounts.end(); i++) {
 			if (i->first.startsWith(path)) {
 				auto newMountPathSub = i->first.relative().str().erase(0, path.relative().str().size());
@@ -105,8 +164,13 @@ int FileSystemRoot::copy(Path from, Path to, bool recursive) {
 	auto deviceTo = getDevice(to, pendingTo);
 	if (!deviceTo.isValid()) return 1;
 	
-	auto f = deviceFrom->get(pendingFrom);
-	auto t = deviceTo->get(pendingTo);
+	SRef<Node> f, t;
+	{
+		ReadLock lock(deviceFrom->mutex);
+		f = deviceFrom->get(pendingFrom);
+	}
+	WriteLock lockTo(deviceTo->mutex);
+	t = deviceTo->get(pendingTo);
 
 	if (!recursive && dynamic_cast<Directory*>(f.get())) return 1;
 
@@ -129,19 +193,29 @@ int FileSystemRoot::copy(Path from, Path to, bool recursive) {
 
 	SRef<Directory> tDir = t;
 	SRef<File> tFile = t;
+	SRef<FileStream> ofs = tFile.isValid() ? tFile->open(OUTPUT) : nullptr;
+	lockTo.unlock();
 	if (tDir.isValid()) {
 		SRef<Directory> fDir = f;
 		if (!fDir.isValid()) return 1;
+		std::unordered_set<std::string> children;
+		{
+			ReadLock lock(deviceFrom->mutex);
+			children = fDir->getChilds();
+		}
 		bool ret = true;
-		for (auto& child : fDir->getChilds()) {
+		for (auto& child : children) {
 			if (copy(from / child, to / child)) ret = false;
 		}
 		return ret ? 0 : 2;
 	} else if (tFile.isValid()) {
-		auto ofs = tFile->open(OUTPUT);
-		auto ifs = f->open(INPUT);
+		SRef<FileStream> ifs;
+		{
+			ReadLock lock(deviceFrom->mutex);
+			ifs = f->open(INPUT);
+		}
 		if (!ofs.isValid() || !ifs.isValid()) return 1;
-		ofs->write(FileStream::readAll(ifs));
+		LockedFileStream(deviceTo, ofs).write(FileStream::readAll(new LockedFileStream(deviceFrom, ifs)));
 		ofs->close();
 	}
 	return 1;
@@ -157,8 +231,13 @@ int FileSystemRoot::moveInternal(Path from, Path to) {
 	auto deviceTo = getDevice(to, pendingTo);
 	if (!deviceTo.isValid()) return 1;
 
-	auto f = deviceFrom->get(pendingFrom);
-	auto t = deviceTo->get(pendingTo);
+	SRef<Node> f, t;
+	{
+		ReadLock lock(deviceFrom->mutex);
+		f = deviceFrom->get(pendingFrom);
+	}
+	WriteLock lockTo(deviceTo->mutex);
+	t = deviceTo->get(pendingTo);
 
 	if (!t.isValid()) {
 		SRef<Directory> prevT = deviceTo->get(pendingTo / "..");
@@ -183,21 +262,31 @@ int FileSystemRoot::moveInternal(Path from, Path to) {
 
 	SRef<Directory> tDir = t;
 	SRef<File> tFile = t;
+	SRef<FileStream> ofs = tFile.isValid() ? tFile->open(OUTPUT) : nullptr;
+	lockTo.unlock();
 	if (tDir.isValid()) {
 		SRef<Directory> fDir = f;
 		if (!fDir.isValid()) return 1;
+		std::unordered_set<std::string> children;
+		{
+			ReadLock lock(deviceFrom->mutex);
+			children = fDir->getChilds();
+		}
 		bool ret = true;
-		for (auto& child : fDir->getChilds()) {
+		for (auto& child : children) {
 			bool able = moveInternal(from / child, to / child) > 0;
 			if (!able) ret = false;
 		}
 		if (ret) remove(from, true);
 		return ret ? 0 : 2;
 	} else if (tFile.isValid()) {
-		auto ofs = tFile->open(OUTPUT);
-		auto ifs = f->open(INPUT);
+		SRef<FileStream> ifs;
+		{
+			ReadLock lock(deviceFrom->mutex);
+			ifs = f->open(INPUT);
+		}
 		if (!ofs.isValid() || !ifs.isValid()) return 1;
-		ofs->write(FileStream::readAll(ifs));
+		LockedFileStream(deviceTo, ofs).write(FileStream::readAll(new LockedFileStream(deviceFrom, ifs)));
 		ofs->close();
 		ifs->close();
 		return remove(from, false);
@@ -212,26 +301,38 @@ int FileSystemRoot::move(Path from, Path to) {
 	Path pendingFrom = "";
 	auto deviceFrom = getDevice(from / "..", pendingFrom);
 	if (!deviceFrom.isValid()) return 1;
-	auto prevFrom = deviceFrom->get(pendingFrom);
+	SRef<Node> prevFrom;
+	{
+		ReadLock lock(deviceFrom->mutex);
+		prevFrom = deviceFrom->get(pendingFrom);
+	}
 	if (!prevFrom.isValid()) return 1;
 	return moveInternal(from, to);
 }
 
 SRef<Node> FileSystemRoot::get(Path path) {
 	path = path.absolute();
-	auto cached_node = cache.find(path);
-	if (cached_node != cache.end()) {
-		if (!cached_node->second.isValid()) {
-			cache.erase(cached_node);
-		} else {
-			return cached_node->second;
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		auto cached_node = cache.find(path);
+		if (cached_node != cache.end()) {
+			if (!cached_node->second.isValid()) {
+				cache.erase(cached_node);
+			} else {
+				return cached_node->second;
+			}
 		}
 	}
 	Path pending = "";
 	auto device = getDevice(path, pending);
 	if (!device.isValid()) return nullptr;
-	auto node = device->get(pending);
+	SRef<Node> node;
+	{
+		ReadLock lock(device->mutex);
+		node = device->get(pending);
+	}
 	if (!node.isValid()) return nullptr;
+	std::lock_guard<std::mutex> lock(cacheMutex);
 	return cache[path] = node;
 }
 
@@ -240,7 +341,12 @@ unordered_set<std::string> FileSystemRoot::childs(Path path) {
 	Path pending = "";
 	auto device = getDevice(path, pending);
 	if (!device.isValid()) throw FileSystemException("no device at path found");
-	unordered_set<std::string> names = device->childs(pending);
+	unordered_set<std::string> names;
+	{
+		ReadLock lock(device->mutex);
+		names = device->childs(pending);
+	}
+	ReadLock lock(mountsMutex);
 	for (auto mount : mounts) {
 		Path mountPoint = mount.first;
 		if (!mountPoint.isRoot() && (mountPoint / "..") == path) names.insert(mountPoint.fileName());
@@ -250,21 +356,40 @@ unordered_set<std::string> FileSystemRoot::childs(Path path) {
 
 bool FileSystemRoot::mount(SRef<Device> device, Path path) {
 	path = path.absolute();
-	for (auto& mount : mounts) {
-		if (mount.first == path && mount.second.first == device) return false;
+	SRef<PathBoundListener> deviceListener = new PathBoundListener(listener, path);
+	{
+		WriteLock lock(mountsMutex);
+		for (auto mount = mounts.begin(); mount != mounts.end();) {
+			if (!mount->second.first.isValid()) mount = mounts.erase(mount);
+			else if (mount->first == path && mount->second.first == device) return false;
+			else ++mount;
+		}
+		mounts[path] = {device, deviceListener};
+	}
+	{
+		WriteLock lock(device->mutex);
+		device->addListener(deviceListener);
 	}
-	device->addListener((mounts[path] = {device, new PathBoundListener(listener, path)}).second);
 	listener->onMounted(path, device);
 	return true;
 }
 
 bool FileSystemRoot::unmount(Path path) {
 	path = path.absolute();
-	auto p = mounts.find(path);
-	if (p == mounts.end()) return false;
-	p->second.first->removeListener(p->second.second);
-	listener->onUnmounted(path, p->second.first);
-	mounts.erase(p);
+	std::pair<WRef<Device>, SRef<PathBoundListener>> mount;
+	{
+		WriteLock lock(mountsMutex);
+		auto p = mounts.find(path);
+		if (p == mounts.end()) return false;
+		mount = p->second;
+		mounts.erase(p);
+	}
+	SRef<Device> device = mount.first;
+	if (device.isValid()) {
+		WriteLock lock(device->mutex);
+		device->removeListener(mount.second);
+	}
+	listener->onUnmounted(path, device);
 	return true;
 }
 
@@ -281,12 +406,16 @@ FileSystemRoot::RootListener::RootListener(FileSystemRoot * root) : root(root) {
 CodersFileSystem::FileSystemRoot::RootListener::~RootListener() {}
 
 void FileSystemRoot::RootListener::onMounted(Path path, SRef<Device> device) {
+	std::unique_lock<std::mutex> lock(root->cacheMutex);
 	for (auto i = root->cache.begin(); i != root->cache.end(); i++) if (i->first.startsWith(path)) root->cache.erase(i--);
+	lock.unlock();
 	root->listeners.onMounted(path, device);
 }
 
 void FileSystemRoot::RootListener::onUnmounted(Path path, SRef<Device> device) {
+	std::unique_lock<std::mutex> lock(root->cacheMutex);
 	for (auto i = root->cache.begin(); i != root->cache.end(); i++) if (i->first.startsWith(path)) root->cache.erase(i--);
+	lock.unlock();
 	root->listeners.onUnmounted(path, device);
 }
 
@@ -295,7 +424,10 @@ void FileSystemRoot::RootListener::onNodeAdded(Path path, NodeType type) {
 }
 
 void FileSystemRoot::RootListener::onNodeRemoved(Path path, NodeType type) {
-	root->cache.erase(path);
+	{
+		std::lock_guard<std::mutex> lock(root->cacheMutex);
+		root->cache.erase(path);
+	}
 	root->listeners.onNodeRemoved(path, type);
 }
 
@@ -305,6 +437,7 @@ void FileSystemRoot::RootListener::onNodeChanged(Path path, NodeType type) {
 
 void CodersFileSystem::FileSystemRoot::RootListener::onNodeRenamed(Path newPath, Path oldPath, NodeType type) {
 	try {
+		std::lock_guard<std::mutex> lock(root->cacheMutex);
 		root->cache[newPath] = root->cache.at(oldPath);
 		root->cache.erase(oldPath);
 	} catch (...) {}
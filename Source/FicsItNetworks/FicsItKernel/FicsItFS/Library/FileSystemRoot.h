@@ -1,6 +1,8 @@
 #pragma once
 
 #include <map>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_set>
 
 #include "Directory.h"
@@ -12,6 +14,36 @@ namespace CodersFileSystem {
 		FileSystemException(std::string what);
 	};
 
+	/**
+	 * Wraps a file stream opened through the file system root,
+	 * so every I/O operation holds the lock of the device the file belongs to.
+	 * The stream itself is additionally guarded by its own lock (always taken after the device lock),
+	 * so closing it (which listeners do while the device is locked) never races with other operations on the stream.
+	 */
+	class LockedFileStream : public FileStream {
+	protected:
+		SRef<Device> device;
+		SRef<FileStream> stream;
+		std::mutex streamMutex;
+
+	public:
+		LockedFileStream(SRef<Device> device, SRef<FileStream> stream);
+
+		using FileStream::read;
+		virtual void write(std::string_view str) override;
+		virtual size_t read(char* buffer, size_t chars) override;
+		virtual bool isEOF() override;
+		virtual std::int64_t seek(std::string w, std::int64_t off) override;
+		virtual void close() override;
+		virtual bool isOpen() override;
+	};
+
+	/**
+	 * The root of a file system, all nodes are accessed through the devices mounted to it.
+	 * All functions are thread-safe, the mount points are guarded by a reader/writer lock
+	 * and every device operation holds the lock of the device.
+	 * Listeners get notified while the device is locked, so the mounts lock is never held while locking a device.
+	 */
 	class FileSystemRoot {
 	protected:
 		class RootListener : public Listener {
@@ -33,7 +65,9 @@ namespace CodersFileSystem {
 		};
 
 		std::map<Path, std::pair<WRef<Device>, SRef<PathBoundListener>>> mounts;
+		std::shared_mutex mountsMutex;
 		std::map<Path, SRef<Node>> cache;
+		std::mutex cacheMutex;
 		ListenerList listeners;
 		SRef<RootListener> listener;
 
@@ -0,0 +1,150 @@
+#include "LinuxFileWatcher.h"
+
+#include "CoreMinimal.h"
+
+#if PLATFORM_LINUX
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "Path.h"
+#include "Listener.h"
+
+namespace fs = std::filesystem;
+
+namespace CodersFileSystem {
+	static constexpr uint32_t WatchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO;
+
+	static std::string joinPath(const std::string& parent, const std::string& child) {
+		return parent.empty() ? child : parent + "/" + child;
+	}
+
+	static bool isSubPath(const std::string& path, const std::string& parent) {
+		return path == parent || (path.length() > parent.length() && path.compare(0, parent.length(), parent) == 0 && path[parent.length()] == '/');
+	}
+
+	LinuxFileWatcher::LinuxFileWatcher(const std::filesystem::path& path, std::function<void(int, NodeType, Path, Path)> event) : eventFunc(event), realPath(path) {
+		inotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (inotifyHandle < 0) return;
+		active = true;
+		addWatch("");
+		if (!active) deactivate();
+	}
+
+	LinuxFileWatcher::~LinuxFileWatcher() {
+		if (inotifyHandle >= 0) close(inotifyHandle);
+	}
+
+	bool LinuxFileWatcher::isActive() const {
+		return active;
+	}
+
+	void LinuxFileWatcher::tick() {
+		if (!active) return;
+		alignas(inotify_event) char buffer[4096];
+		while (true) {
+			ssize_t len = read(inotifyHandle, buffer, sizeof(buffer));
+			if (len <= 0) break;
+			for (char* ptr = buffer; ptr < buffer + len;) {
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+				handleEvent(event);
+				ptr += sizeof(inotify_event) + event->len;
+			}
+		}
+		flushPendingMove();
+		if (!active) {
+			deactivate();
+			// changes might have been missed since the watch failed
+			eventFunc(4, NT_Directory, Path(), Path());
+		}
+	}
+
+	void LinuxFileWatcher::addWatch(const std::string& relativePath) {
+		fs::path dir = realPath / relativePath;
+		int wd = inotify_add_watch(inotifyHandle, dir.c_str(), WatchMask);
+		if (wd < 0) {
+			// changes within the directory would go unnoticed, tear the watcher down once we are done with the current events
+			active = false;
+			return;
+		}
+		watches[wd] = relativePath;
+		std::error_code error;
+		for (const auto& entry : fs::directory_iterator(dir, error)) {
+			if (entry.is_directory(error)) addWatch(joinPath(relativePath, entry.path().filename().string()));
+		}
+	}
+
+	void LinuxFileWatcher::deactivate() {
+		active = false;
+		if (inotifyHandle >= 0) close(inotifyHandle);
+		inotifyHandle = -1;
+		watches.clear();
+		pendingMoveCookie = 0;
+	}
+
+	void LinuxFileWatcher::removeWatches(const std::string& relativePath) {
+		for (auto watch = watches.begin(); watch != watches.end();) {
+			if (isSubPath(watch->second, relativePath)) {
+				inotify_rm_watch(inotifyHandle, watch->first);
+				watch = watches.erase(watch);
+			} else ++watch;
+		}
+	}
+
+	void LinuxFileWatcher::renameWatches(const std::string& from, const std::string& to) {
+		for (auto& watch : watches) {
+			if (isSubPath(watch.second, from)) watch.second = to + watch.second.substr(from.length());
+		}
+	}
+
+	void LinuxFileWatcher::flushPendingMove() {
+		if (!pendingMoveCookie) return;
+		// the node got moved out of the watched tree
+		pendingMoveCookie = 0;
+		if (pendingMoveIsDir) removeWatches(pendingMovePath);
+		eventFunc(1, pendingMoveIsDir ? NT_Directory : NT_File, pendingMovePath, Path());
+	}
+
+	void LinuxFileWatcher::handleEvent(const inotify_event* event) {
+		if (event->mask & IN_Q_OVERFLOW) {
+			eventFunc(4, NT_Directory, Path(), Path());
+			return;
+		}
+		if (event->mask & IN_IGNORED) {
+			watches.erase(event->wd);
+			return;
+		}
+		auto watch = watches.find(event->wd);
+		if (watch == watches.end() || event->len == 0) return;
+		
+		std::string path = joinPath(watch->second, event->name);
+		bool isDir = event->mask & IN_ISDIR;
+		NodeType type = isDir ? NT_Directory : NT_File;
+		if (!(event->mask & IN_MOVED_TO)) flushPendingMove();
+		
+		if (event->mask & IN_CREATE) {
+			if (isDir) addWatch(path);
+			eventFunc(0, type, path, Path());
+		} else if (event->mask & IN_DELETE) {
+			eventFunc(1, type, path, Path());
+		} else if (event->mask & IN_MODIFY) {
+			eventFunc(2, type, path, Path());
+		} else if (event->mask & IN_MOVED_FROM) {
+			pendingMoveCookie = event->cookie;
+			pendingMovePath = path;
+			pendingMoveIsDir = isDir;
+		} else if (event->mask & IN_MOVED_TO) {
+			if (pendingMoveCookie && pendingMoveCookie == event->cookie) {
+				pendingMoveCookie = 0;
+				if (isDir) renameWatches(pendingMovePath, path);
+				eventFunc(3, type, path, pendingMovePath);
+			} else {
+				flushPendingMove();
+				if (isDir) addWatch(path);
+				eventFunc(0, type, path, Path());
+			}
+		}
+	}
+}
+
+#endif
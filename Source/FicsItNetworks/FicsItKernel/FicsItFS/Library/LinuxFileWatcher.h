@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+
+#include "FileSystem.h"
+#include "Listener.h"
+
+struct inotify_event;
+
+namespace CodersFileSystem {
+
+	/**
+	 * inotify based counterpart of the WindowsFileWatcher.
+	 * inotify doesn't watch recursively, so every directory of the watched tree gets its own watch.
+	 * If inotify isn't available or a directory can't be watched (f.e. because the watch limit got reached),
+	 * the watcher stops watching and reports itself inactive, so the device doesn't rely on incomplete events.
+	 *
+	 * Event types passed to the event function: 0 = added, 1 = removed, 2 = changed, 3 = renamed, 4 = events got lost.
+	 */
+	class LinuxFileWatcher {
+	public:
+		std::function<void(int, NodeType, Path, Path)> eventFunc;
+		std::filesystem::path realPath;
+
+		LinuxFileWatcher(const std::filesystem::path& path, std::function<void(int, NodeType, Path, Path)> eventFunc);
+		~LinuxFileWatcher();
+		void tick();
+
+		/**
+		 * Returns true if the watcher reports all changes of the watched tree
+		 */
+		bool isActive() const;
+
+	private:
+		int inotifyHandle = -1;
+		bool active = false;
+		std::unordered_map<int, std::string> watches;
+		uint32_t pendingMoveCookie = 0;
+		std::string pendingMovePath;
+		bool pendingMoveIsDir = false;
+
+		void addWatch(const std::string& relativePath);
+		void deactivate();
+		void removeWatches(const std::string& relativePath);
+		void renameWatches(const std::string& from, const std::string& to);
+		void flushPendingMove();
+		void handleEvent(const inotify_event* event);
+	};
+}
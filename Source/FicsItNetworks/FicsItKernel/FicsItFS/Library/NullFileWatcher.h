@@ -0,0 +1,22 @@
+#pragma once
+
+#include <functional>
+
+#include "FileSystem.h"
+#include "Listener.h"
+
+namespace CodersFileSystem {
+
+	/**
+	 * Watcher for platforms without a native file watcher implementation.
+	 * Never reports any changes and is never active, so the device scans the real file system instead.
+	 */
+	class NullFileWatcher {
+	public:
+		std::filesystem::path realPath;
+
+		NullFileWatcher(const std::filesystem::path& path, std::function<void(int, NodeType, Path, Path)> eventFunc) : realPath(path) {}
+		void tick() {}
+		bool isActive() const { return false; }
+	};
+}
@@ -83,3 +83,41 @@ void CodersFileSystem::Tests::TestPath() {
 	check(rootOverride.fileName() == "meep");
 	check(!rootOverride.isDir());
 }
+
+void CodersFileSystem::Tests::TestMemFile() {
+	SRef<MemDevice> device = new MemDevice(MemFileData::PageSize * 4);
+	std::string page(MemFileData::PageSize, 'a');
+
+	SRef<FileStream> stream = device->open("/test", OUTPUT);
+	check(stream.isValid());
+	stream->write(page);
+	stream->write("bbbb");
+	check(device->getUsed() == std::string("test").length() + MemFileData::PageSize + 4);
+
+	stream->seek("set", MemFileData::PageSize - 2);
+	stream->write("cccc");
+	check(device->getUsed() == std::string("test").length() + MemFileData::PageSize + 4);
+	stream->write("dd");
+	check(device->getUsed() == std::string("test").length() + MemFileData::PageSize + 4);
+	stream->write("ee");
+	check(device->getUsed() == std::string("test").length() + MemFileData::PageSize + 6);
+	stream->close();
+
+	stream = device->open("/test", INPUT);
+	check(stream->read(MemFileData::PageSize - 2) == page.substr(0, MemFileData::PageSize - 2));
+	check(stream->read(100) == "ccccddee");
+	check(stream->read(1) == "");
+	check(stream->isEOF());
+	stream->close();
+
+	stream = device->open("/test", OUTPUT | TRUNC);
+	check(device->getUsed() == std::string("test").length());
+	bool bOutOfMemory = false;
+	try {
+		stream->write(std::string(MemFileData::PageSize * 4, 'f'));
+	} catch (...) {
+		bOutOfMemory = true;
+	}
+	check(bOutOfMemory);
+	stream->close();
+}
@@ -3,5 +3,6 @@
 namespace CodersFileSystem {
 	namespace Tests {
 		void TestPath();
+		void TestMemFile();
 	}
 }
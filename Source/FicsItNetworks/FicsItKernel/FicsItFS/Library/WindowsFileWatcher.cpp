@@ -1,5 +1,7 @@
 #include "WindowsFileWatcher.h"
 
+#if PLATFORM_WINDOWS
+
 #include "Engine.h"
 #define WIN32_LEAN_AND_MEAN
 #include "Windows.h"
@@ -30,8 +32,8 @@ namespace CodersFileSystem {
 			NULL);
 		ZeroMemory(&watcherInfo->OverlappedIO, sizeof(watcherInfo->OverlappedIO));
 		watcherInfo->OverlappedIO.hEvent = CreateEvent(NULL, true, false, NULL);
-		
-		tryReadChanges();
+
+		active = watcherInfo->DirectoryHandle != INVALID_HANDLE_VALUE && watcherInfo->OverlappedIO.hEvent != NULL && tryReadChanges();
 	}
 
 	WindowsFileWatcher::~WindowsFileWatcher() {
@@ -40,10 +42,23 @@ namespace CodersFileSystem {
 		delete watcherInfo;
 	}
 
+	bool WindowsFileWatcher::isActive() const {
+		return active;
+	}
+
 	void WindowsFileWatcher::tick() {
+		if (!active) return;
 		DWORD status = WaitForSingleObject(watcherInfo->OverlappedIO.hEvent, 0);
 		if (status != WAIT_OBJECT_0) return;
 
+		DWORD bytes = 0;
+		if (!GetOverlappedResult(watcherInfo->DirectoryHandle, &watcherInfo->OverlappedIO, &bytes, false) || bytes == 0) {
+			// the buffer overflowed and the events got dropped
+			eventFunc(4, NT_Directory, Path(), Path());
+			continueReading();
+			return;
+		}
+
 		FILE_NOTIFY_INFORMATION* Event = (FILE_NOTIFY_INFORMATION*)watcherInfo->Buffer;
 		
 		while (true) {
@@ -53,12 +68,12 @@ namespace CodersFileSystem {
 				*((uint8**)&Event) += Event->NextEntryOffset;
 			} else break;
 		}
-		tryReadChanges();
+		continueReading();
 	}
 
-	void WindowsFileWatcher::tryReadChanges() {
+	bool WindowsFileWatcher::tryReadChanges() {
 		memset(&watcherInfo->Buffer, 0, sizeof(watcherInfo->Buffer));
-		ReadDirectoryChangesW(
+		const BOOL bReading = ReadDirectoryChangesW(
 			watcherInfo->DirectoryHandle,
 			&watcherInfo->Buffer,
 			sizeof(watcherInfo->Buffer),
@@ -67,6 +82,14 @@ namespace CodersFileSystem {
 			NULL,
 			&watcherInfo->OverlappedIO,
 			NULL);
+		return bReading != 0;
+	}
+
+	void WindowsFileWatcher::continueReading() {
+		if (tryReadChanges()) return;
+		// no further changes will get reported, changes might have been missed already
+		active = false;
+		eventFunc(4, NT_Directory, Path(), Path());
 	}
 
 	void WindowsFileWatcher::handleChangeEvent(FILE_NOTIFY_INFORMATION* changeEvent) {
@@ -94,3 +117,5 @@ namespace CodersFileSystem {
 		}
 	}
 }
+
+#endif
@@ -5,12 +5,17 @@
 #include "AkAcousticPortal.h"
 #include "FileSystem.h"
 
+#if PLATFORM_WINDOWS
+
 namespace CodersFileSystem {
 	enum NodeType;
 	class Path;
 
 	struct DiskDeviceWatcher;
 	
+	/**
+	 * Event types passed to the event function: 0 = added, 1 = removed, 2 = changed, 3 = renamed, 4 = events got lost.
+	 */
 	class WindowsFileWatcher {
 	public:
 		DiskDeviceWatcher* watcherInfo = nullptr;
@@ -22,8 +27,18 @@ namespace CodersFileSystem {
 		~WindowsFileWatcher();
 		void tick();
 
+		/**
+		 * Returns true if the watcher reports all changes of the watched tree
+		 */
+		bool isActive() const;
+
 	private:
-		void tryReadChanges();
+		bool active = false;
+
+		bool tryReadChanges();
+		void continueReading();
 		void handleChangeEvent(::FILE_NOTIFY_INFORMATION* changeEvent);
 	};
-}
\ No newline at end of file
+}
+
+#endif
@@ -46,10 +46,43 @@ void FFINKernelFSSerial::write(std::string str) {
 	}
 }
 
-std::string FFINKernelFSSerial::readOutput() {
+void FFINKernelFSSerial::writeOutput(const char* data, size_t len) {
 	FScopeLock Lock(&Mutex);
-	std::string str = output.str();
-	output = std::stringstream();
+	std::uint64_t sequence = outputSequence.load(std::memory_order_relaxed);
+	if (len > OutputCapacity) {
+		sequence += len - OutputCapacity;
+		data += len - OutputCapacity;
+		len = OutputCapacity;
+	}
+	size_t pos = sequence % OutputCapacity;
+	size_t first = FMath::Min(len, OutputCapacity - pos);
+	memcpy(outputBuffer + pos, data, first);
+	memcpy(outputBuffer, data + first, len - first);
+	outputSequence.store(sequence + len, std::memory_order_release);
+}
+
+std::uint64_t FFINKernelFSSerial::getOutputSequence() const {
+	return outputSequence.load(std::memory_order_acquire);
+}
+
+std::string FFINKernelFSSerial::readOutput(std::uint64_t& sequence) {
+	FScopeLock Lock(&Mutex);
+	const std::uint64_t endSequence = outputSequence.load(std::memory_order_relaxed);
+	std::uint64_t startSequence = FMath::Min(sequence, endSequence);
+	const bool bOverwritten = endSequence - startSequence > OutputCapacity;
+	if (bOverwritten) startSequence = endSequence - OutputCapacity;
+	sequence = endSequence;
+	size_t len = endSequence - startSequence;
+	size_t start = startSequence % OutputCapacity;
+	std::string str;
+	str.reserve(len);
+	str.append(outputBuffer + start, FMath::Min(len, OutputCapacity - start));
+	str.append(outputBuffer, len - str.length());
+	if (bOverwritten) {
+		size_t skip = 0;
+		while (skip < str.length() && (str[skip] & 0xC0) == 0x80) ++skip;
+		str.erase(0, skip);
+	}
 	return str;
 }
 
@@ -57,26 +90,17 @@ FFINKernelSerialStream::FFINKernelSerialStream(CodersFileSystem::SRef<FFINKernel
 
 FFINKernelSerialStream::~FFINKernelSerialStream() {}
 
-void FFINKernelSerialStream::write(std::string str) {
+void FFINKernelSerialStream::write(std::string_view str) {
 	if (!(mode & CodersFileSystem::OUTPUT)) return;
-	FScopeLock Lock(&serial->Mutex);
-	serial->output << str;
-	serial->output.flush();
+	serial->writeOutput(str.data(), str.length());
 }
 
-std::string FFINKernelSerialStream::read(size_t chars) {
-	if (!(mode & CodersFileSystem::INPUT)) return "";
-	char* buf = new char[chars];
-	try {
-		input.read(buf, chars);
-	} catch (std::ios::failure e) {
-		delete[] buf;
-		throw;
-	}
-	std::string s(buf);
-	delete[] buf;
-	input = std::stringstream(input.str().erase(0, input.tellg()));
-	return s;
+size_t FFINKernelSerialStream::read(char* buffer, size_t chars) {
+	if (!(mode & CodersFileSystem::INPUT)) return 0;
+	input.read(buffer, chars);
+	const size_t count = input.gcount();
+	input = std::stringstream(input.str().erase(0, count));
+	return count;
 }
 
 std::int64_t FFINKernelSerialStream::seek(std::string str, std::int64_t off) {
@@ -1,12 +1,20 @@
 #pragma once
 
 #include "Library/File.h"
+#include <atomic>
 
 class FICSITNETWORKS_API FFINKernelFSSerial : public CodersFileSystem::File {
 	friend class FFINKernelSerialStream;
 
+public:
+	/**
+	 * The amount of bytes of serial output the ring buffer retains
+	 */
+	static constexpr size_t OutputCapacity = 1024;
+
 private:
-	std::stringstream output;
+	char outputBuffer[OutputCapacity];
+	std::atomic<std::uint64_t> outputSequence{0};
 	std::unordered_set<CodersFileSystem::WRef<FFINKernelSerialStream>> inStreams;
 	CodersFileSystem::ListenerListRef listeners;
 	CodersFileSystem::SizeCheckFunc sizeCheck;
@@ -40,11 +48,30 @@ public:
 	void write(std::string str);
 
 	/*
-	 * Reads all from the output stream, causes the output stream to get cleared
+	 * Appends the given data to the output ring buffer, overwriting the oldest output once the buffer is full
+	 *
+	 * @param	data	the data to append
+	 * @param	len		the amount of bytes to append
+	 */
+	void writeOutput(const char* data, size_t len);
+
+	/*
+	 * Returns the amount of bytes ever written to the output.
+	 * Can be used to check cheaply if new output is available.
+	 *
+	 * @return	the current output sequence number
+	 */
+	std::uint64_t getOutputSequence() const;
+
+	/*
+	 * Reads the output written since the given output sequence number, does not consume it.
+	 * If parts of that output got overwritten already, only the retained output gets returned
+	 * and incomplete UTF-8 characters at its start get skipped.
 	 *
-	 * @return	the contents of the output stream
+	 * @param	sequence	the output sequence number to read from, gets set to the sequence number the returned content ends at
+	 * @return	the output written since the given sequence number
 	 */
-	std::string readOutput();
+	std::string readOutput(std::uint64_t& sequence);
 };
 
 class FFINKernelSerialStream : public CodersFileSystem::FileStream {
@@ -61,8 +88,9 @@ public:
 	~FFINKernelSerialStream();
 
 	// Begin FileSystem::FileStream
-	virtual void write(std::string str) override;
-	virtual std::string read(size_t chars) override;
+	using FileStream::read;
+	virtual void write(std::string_view str) override;
+	virtual size_t read(char* buffer, size_t chars) override;
 	virtual std::int64_t seek(std::string w, std::int64_t off) override;
 	virtual void close() override;
 	virtual bool isEOF() override;
@@ -81,11 +81,11 @@ bool UFINKernelSystem::ShouldSave_Implementation() const {
 }
 
 void UFINKernelSystem::PreSaveGame_Implementation(int32 saveVersion, int32 gameVersion) {
-	SystemResetTimePoint = (FDateTime::Now() - FFicsItNetworksModule::GameStart).GetTotalMilliseconds() - SystemResetTimePoint;
+	SystemResetTimePoint = FFicsItNetworksModule::GetGameMillis() - SystemResetTimePoint;
 }
 
 void UFINKernelSystem::PostSaveGame_Implementation(int32 saveVersion, int32 gameVersion) {
-	SystemResetTimePoint = (FDateTime::Now() - FFicsItNetworksModule::GameStart).GetTotalMilliseconds() - SystemResetTimePoint;
+	SystemResetTimePoint = FFicsItNetworksModule::GetGameMillis() - SystemResetTimePoint;
 }
 
 void UFINKernelSystem::PreLoadGame_Implementation(int32 saveVersion, int32 gameVersion) {}
@@ -109,7 +109,7 @@ void UFINKernelSystem::PostLoadGame_Implementation(int32 saveVersion, int32 game
 		FileSystem.PostLoad(FileSystemSerializationInfo);
 	}
 	
-	SystemResetTimePoint = (FDateTime::Now() - FFicsItNetworksModule::GameStart).GetTotalMilliseconds() - SystemResetTimePoint;
+	SystemResetTimePoint = FFicsItNetworksModule::GetGameMillis() - SystemResetTimePoint;
 }
 
 void UFINKernelSystem::GatherDependencies_Implementation(TArray<UObject*>& out_dependentObjects) {
@@ -202,6 +202,7 @@ void UFINKernelSystem::HandleFutures() {
 		FutureQueue.Pop();
 		(*Future)->Execute();
 	}
+	if (GetProcessor()) GetProcessor()->HandleFutures();
 }
 
 TMap<AFINFileSystemState*, CodersFileSystem::SRef<CodersFileSystem::Device>> UFINKernelSystem::GetDrives() const {
@@ -253,7 +254,7 @@ bool UFINKernelSystem::Start(bool InReset) {
 	}
 	Processor->Reset();
 
-	SystemResetTimePoint = (FDateTime::Now() - FFicsItNetworksModule::GameStart).GetTotalMilliseconds();
+	SystemResetTimePoint = FFicsItNetworksModule::GetGameMillis();
 
 	// finish start
 	return true;
@@ -305,9 +306,11 @@ bool UFINKernelSystem::RecalculateResources(ERecalc InComponents, bool bShouldCr
 	CodersFileSystem::SRef<FFINKernelFSDevDevice> Device = FileSystem.getDevDevice();
 
 	bool bFail = false;
-	MemoryUsage = Processor->GetMemoryUsage(InComponents & PROCESSOR);
+	const int64 ProcessorMemoryUsage = Processor->GetMemoryUsage(InComponents & PROCESSOR);
+	MemoryUsage = ProcessorMemoryUsage;
 	MemoryUsage += FileSystem.getMemoryUsage(InComponents & FILESYSTEM);
 	if (Device && Device->getSerial().isValid()) MemoryUsage += Device->getSerial()->getSize();
+	Processor->SetMemoryBudget(MemoryCapacity - (MemoryUsage - ProcessorMemoryUsage));
 	if (MemoryUsage > MemoryCapacity) {
 		bFail = true;
 		KernelCrash = MakeShared<FFINKernelCrash>("out of memory");
@@ -351,7 +354,7 @@ const TArray<TScriptInterface<IFINPciDeviceInterface>>& UFINKernelSystem::GetPCI
 }
 
 int64 UFINKernelSystem::GetTimeSinceStart() const {
-	return (FDateTime::Now() - FFicsItNetworksModule::GameStart).GetTotalMilliseconds() - SystemResetTimePoint;
+	return FFicsItNetworksModule::GetGameMillis() - SystemResetTimePoint;
 }
 
 void UFINKernelSystem::AddReferencer(void* Referencer, const TFunction<void(void*, FReferenceCollector&)>& CollectorFunc) {
@@ -194,6 +194,7 @@ public:
 
 	/**
 	 * This function should get executed every main thread tick.
+	 * Executes the queued futures and lets the processor wake up programs waiting for futures.
 	 * @note	ONLY FROM THE MAIN THREAD!!!
 	 */
 	void HandleFutures();
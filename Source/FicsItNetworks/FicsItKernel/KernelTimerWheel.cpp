@@ -0,0 +1,49 @@
+#include "KernelTimerWheel.h"
+
+FFINKernelTimerWheel& FFINKernelTimerWheel::Get() {
+	static FFINKernelTimerWheel TimerWheel;
+	return TimerWheel;
+}
+
+uint64 FFINKernelTimerWheel::AddTimer(int64 Deadline, TFunction<void()> Callback) {
+	FScopeLock Lock(&Mutex);
+	// round up so the slot only gets processed once the deadline is reached
+	const int64 Tick = FMath::Max((Deadline + SlotMillis - 1) / SlotMillis, CurrentTick + 1);
+	const int32 Slot = Tick % SlotCount;
+	const uint64 ID = NextID++;
+	Slots[Slot].Add(FTimer{ID, Deadline, MoveTemp(Callback)});
+	TimerSlots.Add(ID, Slot);
+	return ID;
+}
+
+void FFINKernelTimerWheel::RemoveTimer(uint64 ID) {
+	FScopeLock Lock(&Mutex);
+	int32 Slot;
+	if (!TimerSlots.RemoveAndCopyValue(ID, Slot)) return;
+	Slots[Slot].RemoveAllSwap([ID](const FTimer& Timer) {
+		return Timer.ID == ID;
+	});
+}
+
+void FFINKernelTimerWheel::Advance(int64 Now) {
+	TArray<TFunction<void()>> Fired;
+	{
+		FScopeLock Lock(&Mutex);
+		const int64 Tick = Now / SlotMillis;
+		if (Tick <= CurrentTick) return;
+		// if more than one rotation passed, every slot gets visited just once
+		const int64 FirstTick = FMath::Max(CurrentTick + 1, Tick - SlotCount + 1);
+		for (int64 i = FirstTick; i <= Tick; ++i) {
+			TArray<FTimer>& Slot = Slots[i % SlotCount];
+			for (int32 j = 0; j < Slot.Num(); ++j) {
+				if (Slot[j].Deadline > Now) continue;
+				TimerSlots.Remove(Slot[j].ID);
+				Fired.Add(MoveTemp(Slot[j].Callback));
+				Slot.RemoveAtSwap(j--);
+			}
+		}
+		CurrentTick = Tick;
+	}
+	// callbacks get called without lock so they are able to add and remove timers
+	for (const TFunction<void()>& Callback : Fired) Callback();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Hashed timer wheel used to wake up sleeping processors.
+ * Timers have an absolute deadline on the game clock (FFicsItNetworksModule::GetGameMillis)
+ * and get fired in the first Advance call after their deadline,
+ * so waiting processors don't need to poll the clock on every tick.
+ * Timers with deadlines further out than one rotation of the wheel just stay in their slot until their rotation comes.
+ */
+class FICSITNETWORKS_API FFINKernelTimerWheel {
+public:
+	/**
+	 * The amount of milliseconds covered by one slot of the wheel
+	 */
+	static constexpr int64 SlotMillis = 10;
+
+	/**
+	 * The amount of slots in the wheel
+	 */
+	static constexpr int32 SlotCount = 512;
+
+private:
+	struct FTimer {
+		uint64 ID;
+		int64 Deadline;
+		TFunction<void()> Callback;
+	};
+
+	TArray<FTimer> Slots[SlotCount];
+	TMap<uint64, int32> TimerSlots;
+	uint64 NextID = 1;
+	int64 CurrentTick = 0;
+	FCriticalSection Mutex;
+
+public:
+	/**
+	 * Returns the timer wheel of the game, advanced by the module every frame
+	 */
+	static FFINKernelTimerWheel& Get();
+
+	/**
+	 * Adds a new timer to the wheel.
+	 * The callback gets called in the main thread and should be cheap.
+	 *
+	 * @param[in]	Deadline	the game time in milliseconds at which the timer should fire
+	 * @param[in]	Callback	the function that gets called when the timer fires
+	 * @return	the id of the timer, never 0
+	 */
+	uint64 AddTimer(int64 Deadline, TFunction<void()> Callback);
+
+	/**
+	 * Removes the timer with the given id if it didn't fire yet
+	 */
+	void RemoveTimer(uint64 ID);
+
+	/**
+	 * Fires all timers with a deadline up until the given time
+	 *
+	 * @param[in]	Now		the current game time in milliseconds
+	 */
+	void Advance(int64 Now);
+};
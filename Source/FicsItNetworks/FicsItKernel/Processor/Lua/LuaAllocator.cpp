@@ -0,0 +1,87 @@
+#include "LuaAllocator.h"
+
+namespace FicsItKernel {
+	namespace Lua {
+		FLuaPoolAllocator::~FLuaPoolAllocator() {
+			for (void* Block : Blocks) FMemory::Free(Block);
+			for (void* Large : LargeAllocations) FMemory::Free(Large);
+		}
+
+		void* FLuaPoolAllocator::Allocate(size_t Size) {
+			void* Ptr;
+			if (Size > MaxPooledSize) {
+				Ptr = FMemory::Malloc(Size, Granularity);
+				if (!Ptr) return nullptr;
+				LargeAllocations.Add(Ptr);
+				Stats.Reserved += Size;
+			} else {
+				const size_t Class = SizeClass(Size);
+				if (FreeLists[Class]) {
+					Ptr = FreeLists[Class];
+					FreeLists[Class] = FreeLists[Class]->Next;
+				} else {
+					const size_t SlotSize = (Class + 1) * Granularity;
+					if (BlockEnd - BlockCursor < static_cast<ptrdiff_t>(SlotSize)) {
+						char* Block = static_cast<char*>(FMemory::Malloc(BlockSize, Granularity));
+						if (!Block) return nullptr;
+						Blocks.Add(Block);
+						Stats.Reserved += BlockSize;
+						BlockCursor = Block;
+						BlockEnd = Block + BlockSize;
+					}
+					Ptr = BlockCursor;
+					BlockCursor += SlotSize;
+				}
+			}
+			Stats.Used += Size;
+			Stats.Peak = FMath::Max(Stats.Peak, Stats.Used);
+			++Stats.Allocations;
+			return Ptr;
+		}
+
+		void FLuaPoolAllocator::Free(void* Ptr, size_t Size) {
+			Stats.Used -= Size;
+			if (Size > MaxPooledSize) {
+				LargeAllocations.Remove(Ptr);
+				Stats.Reserved -= Size;
+				FMemory::Free(Ptr);
+			} else {
+				const size_t Class = SizeClass(Size);
+				FFreeSlot* Slot = static_cast<FFreeSlot*>(Ptr);
+				Slot->Next = FreeLists[Class];
+				FreeLists[Class] = Slot;
+			}
+		}
+
+		void* FLuaPoolAllocator::LuaAlloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+			FLuaPoolAllocator* Allocator = static_cast<FLuaPoolAllocator*>(ud);
+			// if ptr is null, osize encodes the type of the object instead of a size
+			if (!ptr) osize = 0;
+
+			if (nsize == 0) {
+				if (ptr) Allocator->Free(ptr, osize);
+				return nullptr;
+			}
+
+			if (nsize > osize && Allocator->bEnforceLimit && Allocator->Stats.Used + (nsize - osize) > Allocator->Limit) {
+				++Allocator->Stats.FailedAllocations;
+				return nullptr;
+			}
+
+			// resize within the same size class doesn't need to move the memory
+			if (ptr && osize <= MaxPooledSize && nsize <= MaxPooledSize && SizeClass(osize) == SizeClass(nsize)) {
+				Allocator->Stats.Used = Allocator->Stats.Used - osize + nsize;
+				Allocator->Stats.Peak = FMath::Max(Allocator->Stats.Peak, Allocator->Stats.Used);
+				return ptr;
+			}
+
+			void* NewPtr = Allocator->Allocate(nsize);
+			if (!NewPtr) return nullptr;
+			if (ptr) {
+				FMemory::Memcpy(NewPtr, ptr, FMath::Min(osize, nsize));
+				Allocator->Free(ptr, osize);
+			}
+			return NewPtr;
+		}
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace FicsItKernel {
+	namespace Lua {
+		/**
+		 * Allocation statistics of a lua pool allocator
+		 */
+		struct FLuaAllocatorStats {
+			/**
+			 * Bytes currently allocated by the lua state
+			 */
+			size_t Used = 0;
+
+			/**
+			 * The highest amount of bytes allocated at once
+			 */
+			size_t Peak = 0;
+
+			/**
+			 * Bytes reserved from the system for the pools and large allocations
+			 */
+			size_t Reserved = 0;
+
+			/**
+			 * Count of allocations done
+			 */
+			uint64 Allocations = 0;
+
+			/**
+			 * Count of allocations refused because of the memory limit
+			 */
+			uint64 FailedAllocations = 0;
+		};
+
+		/**
+		 * Allocator of a lua state of a processor.
+		 * Small allocations get served from size class free lists which get filled from big blocks,
+		 * bigger allocations go directly to the system allocator.
+		 * All the memory gets released in bulk when the allocator gets destroyed.
+		 * Allocations exceeding the memory limit fail while the limit is enforced, so lua raises a memory error right away.
+		 * Not thread safe, just like the lua state itself.
+		 */
+		class FLuaPoolAllocator {
+		public:
+			static constexpr size_t Granularity = 16;
+			static constexpr size_t MaxPooledSize = 512;
+			static constexpr size_t BlockSize = 64 * 1024;
+			static constexpr size_t SizeClassCount = MaxPooledSize / Granularity;
+
+		private:
+			struct FFreeSlot {
+				FFreeSlot* Next;
+			};
+
+			FFreeSlot* FreeLists[SizeClassCount] = {};
+			TArray<void*> Blocks;
+			TSet<void*> LargeAllocations;
+			char* BlockCursor = nullptr;
+			char* BlockEnd = nullptr;
+			FLuaAllocatorStats Stats;
+			size_t Limit = TNumericLimits<size_t>::Max();
+			bool bEnforceLimit = false;
+
+			static size_t SizeClass(size_t Size) { return (Size + Granularity - 1) / Granularity - 1; }
+
+			void* Allocate(size_t Size);
+			void Free(void* Ptr, size_t Size);
+
+		public:
+			FLuaPoolAllocator() = default;
+			FLuaPoolAllocator(const FLuaPoolAllocator&) = delete;
+			FLuaPoolAllocator& operator=(const FLuaPoolAllocator&) = delete;
+			~FLuaPoolAllocator();
+
+			/**
+			 * lua_Alloc function, expects the allocator as user data
+			 */
+			static void* LuaAlloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+			/**
+			 * Sets the amount of bytes the lua state is allowed to use
+			 */
+			void SetLimit(size_t InLimit) { Limit = InLimit; }
+
+			/**
+			 * Enables or disables refusing allocations that exceed the limit.
+			 * Should only be enabled while lua runs in protected mode, so a refused allocation raises a lua error.
+			 */
+			void SetEnforceLimit(bool bInEnforceLimit) { bEnforceLimit = bInEnforceLimit; }
+
+			size_t GetLimit() const { return Limit; }
+			const FLuaAllocatorStats& GetStats() const { return Stats; }
+		};
+	}
+}
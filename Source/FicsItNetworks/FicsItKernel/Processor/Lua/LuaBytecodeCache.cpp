@@ -0,0 +1,55 @@
+#include "LuaBytecodeCache.h"
+
+#include "Hash/CityHash.h"
+
+namespace FicsItKernel {
+	namespace Lua {
+		FLuaBytecodeCache& FLuaBytecodeCache::Get() {
+			static FLuaBytecodeCache Cache;
+			return Cache;
+		}
+
+		int FLuaBytecodeCache::Load(lua_State* L, const FString& Code, const char* ChunkName) {
+			// hash the code as it is, so a hit doesn't need the utf-8 conversion
+			const uint64 Hash = CityHash64WithSeed(reinterpret_cast<const char*>(*Code), Code.Len() * sizeof(TCHAR), CityHash64(ChunkName, strlen(ChunkName)));
+			std::string Bytecode;
+			{
+				FScopeLock Lock(&Mutex);
+				const FBytecodeEntry* Entry = Entries.Find(Hash);
+				if (Entry && Entry->ChunkName == ChunkName && Entry->Code.Equals(Code, ESearchCase::CaseSensitive)) Bytecode = Entry->Bytecode;
+			}
+			if (!Bytecode.empty()) {
+				if (luaL_loadbufferx(L, Bytecode.c_str(), Bytecode.size(), ChunkName, "b") == LUA_OK) return LUA_OK;
+				lua_pop(L, 1);
+			}
+
+			const FTCHARToUTF8 CodeConv(*Code, Code.Len());
+			const int Status = luaL_loadbufferx(L, CodeConv.Get(), CodeConv.Length(), ChunkName, "t");
+			if (Status != LUA_OK) return Status;
+			Bytecode.clear();
+			if (lua_dump(L, luaChunkWriter, &Bytecode, 0) != 0) return Status;
+
+			FBytecodeEntry NewEntry;
+			NewEntry.Code = Code;
+			NewEntry.ChunkName = ChunkName;
+			NewEntry.Bytecode = MoveTemp(Bytecode);
+			if (NewEntry.GetSize() > MaxCacheSize) return Status;
+
+			FScopeLock Lock(&Mutex);
+			if (const FBytecodeEntry* Old = Entries.Find(Hash)) CacheSize -= Old->GetSize();
+			if (CacheSize + NewEntry.GetSize() > MaxCacheSize) {
+				Entries.Empty();
+				CacheSize = 0;
+			}
+			CacheSize += NewEntry.GetSize();
+			Entries.Add(Hash, MoveTemp(NewEntry));
+			return Status;
+		}
+
+		void FLuaBytecodeCache::Clear() {
+			FScopeLock Lock(&Mutex);
+			Entries.Empty();
+			CacheSize = 0;
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "LuaUtil.h"
+
+#include <string>
+
+namespace FicsItKernel {
+	namespace Lua {
+		/**
+		 * Process wide cache of compiled Lua code, mapped by the hash of the code.
+		 * Computers booting the same EEPROM code only compile it once,
+		 * all further loads just load the cached bytecode into their state.
+		 * The entries keep the code and chunk name they got compiled from, so a hash collision never loads foreign bytecode.
+		 */
+		class FLuaBytecodeCache {
+		public:
+			/**
+			 * The maximum amount of bytes of bytecode and code the cache holds before it gets flushed
+			 */
+			static constexpr size_t MaxCacheSize = 16 * 1024 * 1024;
+
+		private:
+			struct FBytecodeEntry {
+				FString Code;
+				std::string ChunkName;
+				std::string Bytecode;
+
+				size_t GetSize() const {
+					return Code.Len() * sizeof(TCHAR) + ChunkName.size() + Bytecode.size();
+				}
+			};
+
+			TMap<uint64, FBytecodeEntry> Entries;
+			size_t CacheSize = 0;
+			FCriticalSection Mutex;
+
+		public:
+			/**
+			 * Returns the cache of the process
+			 */
+			static FLuaBytecodeCache& Get();
+
+			/**
+			 * Loads the given code as chunk and pushes the resulting function (or error message) onto the stack like luaL_loadbuffer.
+			 * Uses the cached bytecode if the same code with the same chunk name got compiled before.
+			 *
+			 * @param[in]	L			the lua state the chunk should get loaded into
+			 * @param[in]	Code		the lua source code
+			 * @param[in]	ChunkName	the name of the chunk used in error messages and traces
+			 * @return	the status of the load
+			 */
+			int Load(lua_State* L, const FString& Code, const char* ChunkName);
+
+			/**
+			 * Removes all cached bytecode
+			 */
+			void Clear();
+		};
+	}
+}
@@ -4,8 +4,11 @@
 #include "LuaInstance.h"
 #include "FGBlueprintFunctionLibrary.h"
 #include "LuaProcessor.h"
+#include "LuaFuture.h"
+#include "LuaUtil.h"
 #include "FicsItNetworks/Network/FINNetworkUtils.h"
 #include "FicsItNetworks/Reflection/FINClass.h"
+#include "FicsItNetworks/Reflection/FINReflection.h"
 
 // ReSharper disable once IdentifierTypo
 namespace FicsItKernel {
@@ -78,9 +81,121 @@ namespace FicsItKernel {
 			return UFINLuaProcessor::luaAPIReturn(L, args);
 		}
 
+		/**
+		 * Reads the list of property names from the given index of the given lua stack.
+		 * The names can be given as single string or as array of strings.
+		 */
+		TArray<FString> luaGetPropertyNames(lua_State* L, int Index) {
+			TArray<FString> Names;
+			if (lua_isstring(L, Index)) {
+				Names.Add(lua_tostring(L, Index));
+				return Names;
+			}
+			luaL_checktype(L, Index, LUA_TTABLE);
+			const auto Count = lua_rawlen(L, Index);
+			for (int i = 1; i <= Count; ++i) {
+				lua_geti(L, Index, i);
+				if (!lua_isstring(L, -1)) luaL_argerror(L, Index, "array contains non-string");
+				Names.Add(lua_tostring(L, -1));
+				lua_pop(L, 1);
+			}
+			return Names;
+		}
+
+		/**
+		 * Finds the properties with the given names of the type of the given object.
+		 * Uses the given cache so the lookup only has to be done once per type.
+		 */
+		const TArray<UFINProperty*>& GetBatchProperties(UObject* Obj, const TArray<FString>& Names, TMap<UClass*, TArray<UFINProperty*>>& Cache) {
+			TArray<UFINProperty*>* Properties = Cache.Find(Obj->GetClass());
+			if (Properties) return *Properties;
+			Properties = &Cache.Add(Obj->GetClass());
+			UFINClass* Class = FFINReflection::Get()->FindClass(Obj->GetClass());
+			for (const FString& Name : Names) {
+				Properties->Add(Class ? Class->FindFINProperty(Name, FIN_Prop_Attrib) : nullptr);
+			}
+			return *Properties;
+		}
+		
+		int luaGetProperties(lua_State* L) {
+			luaL_checktype(L, 1, LUA_TTABLE);
+			const TArray<FString> Names = luaGetPropertyNames(L, 2);
+			
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
+
+			TMap<UClass*, TArray<UFINProperty*>> PropertyCache;
+			const auto Count = lua_rawlen(L, 1);
+			lua_createtable(L, Count, 0);
+			for (int i = 1; i <= Count; ++i) {
+				lua_geti(L, 1, i);
+				const FFINNetworkTrace Trace = getObjInstance(L, -1);
+				lua_pop(L, 1);
+				UObject* Obj = *Trace;
+				if (!Obj) continue;
+				
+				const TArray<UFINProperty*>& Properties = GetBatchProperties(Obj, Names, PropertyCache);
+				const FFINExecutionContext Ctx(Trace);
+				lua_createtable(L, Properties.Num(), 0);
+				for (int j = 0; j < Properties.Num(); ++j) {
+					if (!Properties[j]) continue;
+					networkValueToLua(L, Properties[j]->GetValue(Ctx), Trace);
+					lua_seti(L, -2, j+1);
+				}
+				lua_seti(L, -2, i);
+			}
+			return UFINLuaProcessor::luaAPIReturn(L, 1);
+		}
+
+		int luaSetProperties(lua_State* L) {
+			luaL_checktype(L, 1, LUA_TTABLE);
+			const TArray<FString> Names = luaGetPropertyNames(L, 2);
+			luaL_checktype(L, 3, LUA_TTABLE);
+			
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
+
+			FFINFuturePropertyBatch Batch;
+			TMap<UClass*, TArray<UFINProperty*>> PropertyCache;
+			const auto Count = lua_rawlen(L, 1);
+			for (int i = 1; i <= Count; ++i) {
+				lua_geti(L, 1, i);
+				const FFINNetworkTrace Trace = getObjInstance(L, -1);
+				lua_pop(L, 1);
+				UObject* Obj = *Trace;
+				if (!Obj) continue;
+
+				const TArray<UFINProperty*>& Properties = GetBatchProperties(Obj, Names, PropertyCache);
+				const FFINExecutionContext Ctx(Trace);
+				for (int j = 0; j < Properties.Num(); ++j) {
+					UFINProperty* Property = Properties[j];
+					if (!Property || Property->GetPropertyFlags() & FIN_Prop_ReadOnly) continue;
+					lua_geti(L, 3, j+1);
+					FINAny Value = luaToProperty(L, Property, lua_gettop(L));
+					lua_pop(L, 1);
+					
+					if (Property->GetPropertyFlags() & FIN_Prop_RT_Parallel) {
+						try {
+							Property->SetValue(Ctx, Value);
+						} catch (const FFINException& Ex) {
+							Batch.AddError(Property, Ex.GetMessage());
+						}
+					} else {
+						// all sync setters get executed together in the next future pass of the kernel
+						Batch.Entries.Add(FFINFuturePropertyBatchEntry{Ctx, Property, Value});
+					}
+				}
+			}
+			// the future resolves to the errors of all setters, so none of them gets lost
+			luaFuture(L, Batch);
+			return UFINLuaProcessor::luaAPIReturn(L, 1);
+		}
+
 		static const luaL_Reg luaComponentLib[] = {
 			{"proxy", luaComponentProxy},
 			{"findComponent", luaFindComponent},
+			{"getProperties", luaGetProperties},
+			{"setProperties", luaSetProperties},
 			{nullptr, nullptr}
 		};
 
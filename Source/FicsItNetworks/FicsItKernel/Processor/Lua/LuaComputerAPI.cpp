@@ -52,6 +52,25 @@ namespace FicsItKernel {
 			return UFINLuaProcessor::luaAPIReturn(L, 0);
 		}
 
+		int luaComputerMemoryStats(lua_State* L) {
+			const FLuaPoolAllocator* Allocator = UFINLuaProcessor::luaGetProcessor(L)->GetAllocator();
+			const FLuaAllocatorStats& Stats = Allocator->GetStats();
+			lua_createtable(L, 0, 6);
+			lua_pushinteger(L, Stats.Used);
+			lua_setfield(L, -2, "used");
+			lua_pushinteger(L, Stats.Peak);
+			lua_setfield(L, -2, "peak");
+			lua_pushinteger(L, Stats.Reserved);
+			lua_setfield(L, -2, "reserved");
+			lua_pushinteger(L, Stats.Allocations);
+			lua_setfield(L, -2, "allocations");
+			lua_pushinteger(L, Stats.FailedAllocations);
+			lua_setfield(L, -2, "failedAllocations");
+			lua_pushinteger(L, Allocator->GetLimit());
+			lua_setfield(L, -2, "limit");
+			return 1;
+		}
+
 		int luaComputerPromote(lua_State* L) {
 			UFINLuaProcessor* processor = UFINLuaProcessor::luaGetProcessor(L);
 			processor->GetTickHelper().shouldPromote();
@@ -141,6 +160,7 @@ namespace FicsItKernel {
 			{"getEEPROM", luaComputerGetEEPROM},
 			{"time", luaComputerTime},
 			{"millis", luaComputerMillis},
+			{"memoryStats", luaComputerMemoryStats},
 			{"getPCIDevices", luaComputerPCIDevices},
 			{nullptr, nullptr}
 		};
@@ -8,26 +8,105 @@
 #include "FicsItNetworks/Network/FINNetworkTrace.h"
 #include "FicsItNetworks/Network/FINNetworkUtils.h"
 #include "FicsItNetworks/Network/Signals/FINSignalSubsystem.h"
+#include "Resources/FGItemDescriptor.h"
 
 namespace FicsItKernel {
 	namespace Lua {
-		void luaListen(lua_State* L, FFINNetworkTrace o) {
+		/**
+		 * Reads the signal filter table at the given index.
+		 * Raises a lua error if the table is malformed.
+		 */
+		FFINSignalFilter luaToSignalFilter(lua_State* L, int index) {
+			index = lua_absindex(L, index);
+			FFINSignalFilter Filter;
+
+			const int SignalsType = lua_getfield(L, index, "signals");
+			if (SignalsType == LUA_TSTRING) {
+				Filter.Signals.Add(UTF8_TO_TCHAR(lua_tostring(L, -1)));
+			} else if (SignalsType == LUA_TTABLE) {
+				const lua_Integer Count = luaL_len(L, -1);
+				for (lua_Integer i = 1; i <= Count; ++i) {
+					if (lua_geti(L, -1, i) != LUA_TSTRING) luaL_error(L, "signal filter 'signals' has to contain signal names");
+					Filter.Signals.Add(UTF8_TO_TCHAR(lua_tostring(L, -1)));
+					lua_pop(L, 1);
+				}
+			} else if (SignalsType != LUA_TNIL) {
+				luaL_error(L, "signal filter 'signals' has to be a signal name or a table of signal names");
+			}
+			lua_pop(L, 1);
+
+			const int ArgsType = lua_getfield(L, index, "args");
+			if (ArgsType == LUA_TTABLE) {
+				lua_pushnil(L);
+				while (lua_next(L, -2) != 0) {
+					if (!lua_isinteger(L, -2) || lua_tointeger(L, -2) < 1 || !lua_istable(L, -1)) luaL_error(L, "signal filter 'args' has to map parameter indices to predicate tables");
+					FFINSignalArgFilter Arg;
+					Arg.Index = lua_tointeger(L, -2) - 1;
+					if (lua_getfield(L, -1, "equals") != LUA_TNIL) {
+						Arg.Type = FIN_SIGNAL_ARG_EQUALS;
+						luaToNetworkValue(L, -1, Arg.Value);
+						Filter.Args.Add(Arg);
+					}
+					lua_pop(L, 1);
+					const int MinType = lua_getfield(L, -1, "min");
+					const int MaxType = lua_getfield(L, -2, "max");
+					if (MinType != LUA_TNIL || MaxType != LUA_TNIL) {
+						if ((MinType != LUA_TNIL && MinType != LUA_TNUMBER) || (MaxType != LUA_TNIL && MaxType != LUA_TNUMBER)) luaL_error(L, "signal filter range has to be numbers");
+						FFINSignalArgFilter Range;
+						Range.Index = Arg.Index;
+						Range.Type = FIN_SIGNAL_ARG_RANGE;
+						if (MinType == LUA_TNUMBER) Range.Min = lua_tonumber(L, -2);
+						if (MaxType == LUA_TNUMBER) Range.Max = lua_tonumber(L, -1);
+						Filter.Args.Add(Range);
+					}
+					lua_pop(L, 2);
+					if (lua_getfield(L, -1, "item") != LUA_TNIL) {
+						FFINSignalArgFilter Item;
+						Item.Index = Arg.Index;
+						Item.Type = FIN_SIGNAL_ARG_ITEM;
+						Item.ItemType = getClassInstance(L, -1, UFGItemDescriptor::StaticClass());
+						if (!Item.ItemType) luaL_error(L, "signal filter 'item' has to be an item type");
+						Filter.Args.Add(Item);
+					}
+					lua_pop(L, 2);
+				}
+			} else if (ArgsType != LUA_TNIL) {
+				luaL_error(L, "signal filter 'args' has to be a table");
+			}
+			lua_pop(L, 1);
+
+			return Filter;
+		}
+
+		void luaListen(lua_State* L, FFINNetworkTrace o, const FFINSignalFilter* Filter) {
 			const UFINKernelNetworkController* net = UFINLuaProcessor::luaGetProcessor(L)->GetKernel()->GetNetwork();
 			UObject* obj = *o;
 			if (!IsValid(obj)) luaL_error(L, "object is not valid");
 			AFINSignalSubsystem* SigSubSys = AFINSignalSubsystem::GetSignalSubsystem(obj);
-			SigSubSys->Listen(obj, o.Reverse() / net->GetComponent().GetObject());
+			if (Filter) {
+				SigSubSys->ListenFiltered(obj, o.Reverse() / net->GetComponent().GetObject(), *Filter);
+			} else {
+				SigSubSys->Listen(obj, o.Reverse() / net->GetComponent().GetObject());
+			}
 		}
 
 		int luaListen(lua_State* L) {
+			int args = lua_gettop(L);
+
+			// a trailing table is the filter for all given senders
+			TOptional<FFINSignalFilter> Filter;
+			if (args > 0 && lua_type(L, args) == LUA_TTABLE) {
+				Filter = luaToSignalFilter(L, args);
+				--args;
+			}
+			
 			// ReSharper disable once CppDeclaratorNeverUsed
 			FLuaSyncCall SyncCall(L);
-			const int args = lua_gettop(L);
 
 			for (int i = 1; i <= args; ++i) {
 				FFINNetworkTrace trace;
 				UObject* o = getObjInstance<UObject>(L, i, &trace);
-				luaListen(L, trace / o);
+				luaListen(L, trace / o, Filter.GetPtrOrNull());
 			}
 			return UFINLuaProcessor::luaAPIReturn(L, 0);
 		}
@@ -65,8 +144,9 @@ namespace FicsItKernel {
 			const int a = luaProc->DoSignal(L);
 			if (!a && !(args > 0 && lua_isinteger(L, 1) && lua_tointeger(L, 1) == 0)) {
 				luaProc->Timeout = t;
-				luaProc->PullStart =  (FDateTime::Now() - FFicsItNetworksModule::GameStart).GetTotalMilliseconds();
+				luaProc->PullStart = luaProc->GetKernel()->GetTimeSinceStart();
 				luaProc->PullState = (args > 0) ? 1 : 2;
+				if (luaProc->PullState == 1) luaProc->StartPullTimer();
 
 				luaProc->GetTickHelper().shouldWaitForSignal();
 				
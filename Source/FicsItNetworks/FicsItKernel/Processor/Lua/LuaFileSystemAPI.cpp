@@ -3,10 +3,12 @@
 #include "LuaProcessor.h"
 #include "FicsItNetworks/FicsItKernel/FicsItFS/FileSystem.h"
 
+// Reading functions run directly on the async worker, as the file system locks its devices.
+// Functions changing the file system sync with the game thread themselves,
+// as they notify listeners triggering signals and register file streams with the processor.
 #define LuaFunc(funcName) \
 int funcName(lua_State* L) { \
 	UFINLuaProcessor* processor = UFINLuaProcessor::luaGetProcessor(L); \
-	FLuaSyncCall SyncCall(L); \
 	UFINKernelSystem* kernel = processor->GetKernel(); \
 	FFINKernelFSRoot* self = kernel->GetFileSystem(); \
 	if (!self) return luaL_error(L, "component is invalid");
@@ -17,12 +19,12 @@ int funcName(lua_State* L) { \
 #define LuaFileFunc(funcName) \
 int LuaFileFuncName(funcName) (lua_State* L) { \
 	UFINLuaProcessor* processor = UFINLuaProcessor::luaGetProcessor(L); \
-	FLuaSyncCall SyncCall(L); \
 	UFINKernelSystem* kernel = processor->GetKernel(); \
 	LuaFile* self_r = (LuaFile*)luaL_checkudata(L, 1, "File"); \
 	if (!self_r) return luaL_error(L, "file is invalid"); \
 	LuaFile& self = *self_r; \
 	if (self->transfer) { \
+		FLuaSyncCall SyncCall(L); \
 		CodersFileSystem::FileMode mode; \
 		if (self->transfer->open) { \
 			mode = self->transfer->mode; \
@@ -53,6 +55,8 @@ int LuaFileFuncName(funcName) (lua_State* L) { \
 namespace FicsItKernel {
 	namespace Lua {
 		LuaFunc(makeFileSystem) {
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
 			const std::string type = luaL_checkstring(L, 1);
 			const std::string name = luaL_checkstring(L, 2);
 			CodersFileSystem::SRef<CodersFileSystem::Device> device;
@@ -68,6 +72,8 @@ namespace FicsItKernel {
 		} LuaFuncEnd()
 
 		LuaFunc(removeFileSystem) {
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
 			const std::string name = luaL_checkstring(L, 1);
 			const CodersFileSystem::SRef<FFINKernelFSDevDevice> dev = self->getDevDevice();
 			if (dev.isValid()) {
@@ -85,12 +91,16 @@ namespace FicsItKernel {
 		} LuaFuncEnd()
 
 		LuaFunc(initFileSystem) {
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
 			const std::string path = luaL_checkstring(L, 1);
 			lua_pushboolean(L, kernel->InitFileSystem(CodersFileSystem::Path(path)));
 			return UFINLuaProcessor::luaAPIReturn(L, 1);
 		} LuaFuncEnd()
 
 		LuaFunc(open) {
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
 			FString Mode = "r";
 			if (lua_isstring(L, 2)) Mode = FString(lua_tostring(L, 2));
 			CodersFileSystem::FileMode m;
@@ -102,6 +112,7 @@ namespace FicsItKernel {
 			else if (Mode.Contains("a")) m = CodersFileSystem::OUTPUT | CodersFileSystem::APPEND;
 			else return luaL_argerror(L, 2, "is not valid file mode");
 			if (Mode.Contains("b")) m = m | CodersFileSystem::BINARY;
+			if (Mode.Contains("m")) m = m | CodersFileSystem::MAPPED;
 			try {
 				const CodersFileSystem::Path path = CodersFileSystem::Path(luaL_checkstring(L, 1));
 				const CodersFileSystem::SRef<CodersFileSystem::FileStream> stream = self->open(path, m);
@@ -111,6 +122,8 @@ namespace FicsItKernel {
 		} LuaFuncEnd()
 
 		LuaFunc(createDir) {
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
 			const std::string path = luaL_checkstring(L, 1);
 			const bool all = (bool)lua_toboolean(L, 2);
 			try {
@@ -120,6 +133,8 @@ namespace FicsItKernel {
 		} LuaFuncEnd()
 
 		LuaFunc(remove) {
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
 			const CodersFileSystem::Path path = CodersFileSystem::Path(luaL_checkstring(L, 1));
 			const bool all = (bool)lua_toboolean(L, 2);
 			try {
@@ -129,6 +144,8 @@ namespace FicsItKernel {
 		} LuaFuncEnd()
 
 		LuaFunc(move) {
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
 			const auto from = CodersFileSystem::Path(luaL_checkstring(L, 1));
 			const auto to = CodersFileSystem::Path(luaL_checkstring(L, 2));
 			try {
@@ -138,6 +155,8 @@ namespace FicsItKernel {
 		} LuaFuncEnd()
 
 		LuaFunc(rename) {
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
 			const auto from = CodersFileSystem::Path(luaL_checkstring(L, 1));
 			const auto to = std::string(luaL_checkstring(L, 2));
 			try {
@@ -186,6 +205,8 @@ namespace FicsItKernel {
 		} LuaFuncEnd()
 
 		LuaFunc(mount) {
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
 			const auto devPath = CodersFileSystem::Path(luaL_checkstring(L, 1));
 			const auto mountPath = CodersFileSystem::Path(luaL_checkstring(L, 2));
 			try {
@@ -195,6 +216,8 @@ namespace FicsItKernel {
 		} LuaFuncEnd()
 
 		LuaFunc(unmount) {
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
 			const auto mountPath = CodersFileSystem::Path(luaL_checkstring(L, 1));
 			try {
 				lua_pushboolean(L, self->unmount(mountPath));
@@ -206,6 +229,25 @@ namespace FicsItKernel {
 			return lua_gettop(L) - 1;
 		}
 
+		/**
+		 * Loads the given source of the file at the given path as Lua chunk and pushes the resulting function (or error message) like luaL_loadbufferx.
+		 * Reuses the compiled chunk of the chunk cache if the source didn't change since it got compiled last time.
+		 */
+		static int luaLoadFileChunk(lua_State* L, FFINKernelFSRoot* self, const CodersFileSystem::Path& path, const std::string& code) {
+			const std::string chunkName = "@" + path.str();
+			std::string chunk;
+			if (self->getCachedChunk(path, code, chunk)) {
+				if (luaL_loadbufferx(L, chunk.c_str(), chunk.size(), chunkName.c_str(), "b") == LUA_OK) return LUA_OK;
+				lua_pop(L, 1);
+			}
+			const int status = luaL_loadbufferx(L, code.c_str(), code.size(), chunkName.c_str(), "t");
+			if (status == LUA_OK) {
+				chunk.clear();
+				if (lua_dump(L, luaChunkWriter, &chunk, 0) == 0) self->putCachedChunk(path, code, std::move(chunk));
+			}
+			return status;
+		}
+
 		LuaFunc(doFile) {
 			const CodersFileSystem::Path path(luaL_checkstring(L, 1));
 			CodersFileSystem::SRef<CodersFileSystem::FileStream> file;
@@ -220,7 +262,7 @@ namespace FicsItKernel {
 			try {
 				file->close();
 			} CatchExceptionLua
-			luaL_loadbufferx(L, code.c_str(), code.size(), ("@" + path.str()).c_str(), "t");
+			luaLoadFileChunk(L, self, path, code);
 			lua_callk(L, 0, LUA_MULTRET, 0, luaDoFileCont);
 			return luaDoFileCont(L, 0, 0);
 		} LuaFuncEnd()
@@ -240,7 +282,7 @@ namespace FicsItKernel {
 				file->close();
 			} CatchExceptionLua
 			
-			luaL_loadbufferx(L, code.c_str(), code.size(), ("@" + path.str()).c_str(), "t");
+			luaLoadFileChunk(L, self, path, code);
 			return UFINLuaProcessor::luaAPIReturn(L, 1);
 		} LuaFuncEnd()
 		LuaFunc(path) {
@@ -350,6 +392,8 @@ namespace FicsItKernel {
 		};
 
 		LuaFileFunc(Close) {
+			// ReSharper disable once CppDeclaratorNeverUsed
+			FLuaSyncCall SyncCall(L);
 			try {
 				file->close();
 			} CatchExceptionLua
@@ -362,7 +406,7 @@ namespace FicsItKernel {
 				size_t str_len = 0;
 				const char* str = luaL_checklstring(L, i, &str_len);
 				try {
-					file->write(std::string(str, str_len));
+					file->write(std::string_view(str, str_len));
 				} CatchExceptionLua
 			}
 			return UFINLuaProcessor::luaAPIReturn(L, 0);
@@ -371,13 +415,33 @@ namespace FicsItKernel {
 		LuaFileFunc(Read) {
 			const auto args = lua_gettop(L);
 			for (int i = 2; i <= args; ++i) {
-				try {
-					const auto n = lua_tointeger(L, i);
-					std::string s = file->read(n);
-					if (s.size() == 0 && file->isEOF()) lua_pushnil(L);
-					else lua_pushlstring(L, s.c_str(), s.size());
-				} catch (const std::exception& ex) {
-					luaL_error(L, ex.what());
+				// reads directly into a Lua buffer, so the data doesn't get copied around
+				luaL_Buffer buf;
+				if (lua_type(L, i) == LUA_TSTRING && !lua_isnumber(L, i)) {
+					const char* format = lua_tostring(L, i);
+					if (*format == '*') ++format;
+					if (*format != 'a') return luaL_argerror(L, i, "invalid format");
+					try {
+						size_t chunk = FMath::Max<std::int64_t>(file->getRemaining(), 1024);
+						luaL_buffinit(L, &buf);
+						do {
+							luaL_addsize(&buf, file->read(luaL_prepbuffsize(&buf, chunk), chunk));
+							chunk = 1024;
+						} while (!file->isEOF());
+						luaL_pushresult(&buf);
+					} CatchExceptionLua
+				} else {
+					size_t n = FMath::Max<lua_Integer>(lua_tointeger(L, i), 0);
+					try {
+						// never allocate more than the file can return, streams without seek report nothing remaining so allow a chunk for them
+						n = FMath::Min<std::int64_t>(n, FMath::Max<std::int64_t>(file->getRemaining(), 1024));
+						const size_t count = file->read(luaL_buffinitsize(L, &buf, n), n);
+						luaL_pushresultsize(&buf, count);
+						if (count == 0 && file->isEOF()) {
+							lua_pop(L, 1);
+							lua_pushnil(L);
+						}
+					} CatchExceptionLua
 				}
 			}
 			return UFINLuaProcessor::luaAPIReturn(L, args - 1);
@@ -7,31 +7,76 @@ namespace FicsItKernel {
 	namespace Lua {
 		typedef TSharedPtr<TFINDynamicStruct<FFINFuture>> LuaFuture;
 
-		int luaFutureAwaitContinue(lua_State* L, int, lua_KContext) {
-			LuaFuture& future = *static_cast<LuaFuture*>(luaL_checkudata(L, 1, "Future"));
-			if ((*future)->IsDone()) {
-				TArray<FFINAnyNetworkValue> Data = future->Get<FFINFuture>().GetOutput();
-				FFINNetworkTrace Trace;
-				if (future->GetStruct() == FFINFutureReflection::StaticStruct()) Trace = future->Get<FFINFutureReflection>().Context.GetTrace();
-				for (const FFINAnyNetworkValue& Param : Data) networkValueToLua(L, Param, Trace);
-				return Data.Num();
+		// kinds of awaits, passed together with the count of awaited futures as context to the await continuation
+		constexpr lua_KContext FUTURE_AWAIT_SINGLE = 0;
+		constexpr lua_KContext FUTURE_AWAIT_ALL = 1;
+		constexpr lua_KContext FUTURE_AWAIT_ANY = 2;
+		constexpr lua_KContext FUTURE_AWAIT_MODE_MASK = 3;
+		constexpr int FUTURE_AWAIT_COUNT_SHIFT = 2;
+
+		lua_KContext luaFutureAwaitContext(lua_KContext Mode, int FutureCount) {
+			return (static_cast<lua_KContext>(FutureCount) << FUTURE_AWAIT_COUNT_SHIFT) | Mode;
+		}
+
+		int luaFuturePushOutput(lua_State* L, const LuaFuture& future) {
+			const TArray<FFINAnyNetworkValue> Data = (*future)->GetOutput();
+			FFINNetworkTrace Trace;
+			if (future->GetStruct() == FFINFutureReflection::StaticStruct()) Trace = future->Get<FFINFutureReflection>().Context.GetTrace();
+			for (const FFINAnyNetworkValue& Param : Data) networkValueToLua(L, Param, Trace);
+			return Data.Num();
+		}
+
+		int luaFutureAwaitContinue(lua_State* L, int, lua_KContext Ctx) {
+			// the futures we wait for are the first arguments of the await on the stack,
+			// a resume of the coroutine might have pushed additional values we have to get rid of
+			const lua_KContext Mode = Ctx & FUTURE_AWAIT_MODE_MASK;
+			const int FutureCount = static_cast<int>(Ctx >> FUTURE_AWAIT_COUNT_SHIFT);
+			lua_settop(L, FutureCount);
+			TArray<LuaFuture> Futures;
+			int FirstDone = 0;
+			bool bAllDone = true;
+			for (int i = 1; i <= FutureCount; ++i) {
+				const LuaFuture& future = *static_cast<LuaFuture*>(luaL_checkudata(L, i, "Future"));
+				Futures.Add(future);
+				if ((*future)->IsDone()) {
+					if (FirstDone == 0) FirstDone = i;
+				} else {
+					bAllDone = false;
+				}
+			}
+
+			if (Mode == FUTURE_AWAIT_ANY ? FirstDone == 0 : !bAllDone) {
+				// park the runtime until the kernel resolved the futures, no need to resume it in the meantime
+				UFINLuaProcessor::luaGetProcessor(L)->AwaitFutures(Futures, Mode != FUTURE_AWAIT_ANY);
+				return lua_yieldk(L, 0, Ctx, luaFutureAwaitContinue);
+			}
+
+			if (Mode == FUTURE_AWAIT_ANY) {
+				lua_pushinteger(L, FirstDone);
+				return luaFuturePushOutput(L, Futures[FirstDone-1]) + 1;
 			}
-			return lua_yieldk(L, LUA_MULTRET, NULL, luaFutureAwaitContinue);
+			if (Mode == FUTURE_AWAIT_ALL) {
+				for (const LuaFuture& future : Futures) {
+					const int Top = lua_gettop(L);
+					const int OutputCount = luaFuturePushOutput(L, future);
+					lua_createtable(L, OutputCount, 0);
+					lua_insert(L, Top + 1);
+					for (int i = OutputCount; i > 0; --i) lua_seti(L, Top + 1, i);
+				}
+				return FutureCount;
+			}
+			return luaFuturePushOutput(L, Futures[0]);
 		}
 		
 		int luaFutureAwait(lua_State* L) {
 			luaL_checkudata(L, 1, "Future");
-			return lua_yieldk(L, LUA_MULTRET, NULL, luaFutureAwaitContinue);
+			return luaFutureAwaitContinue(L, LUA_OK, luaFutureAwaitContext(FUTURE_AWAIT_SINGLE, 1));
 		}
 
 		int luaFutureGet(lua_State* L) {
 			LuaFuture& future = *static_cast<LuaFuture*>(luaL_checkudata(L, 1, "Future"));
 			luaL_argcheck(L, (*future)->IsDone(), 1, "Future is not ready");
-			const TArray<FFINAnyNetworkValue>& Data = future->Get<FFINFuture>().GetOutput();
-			FFINNetworkTrace Trace;
-			if (future->GetStruct() == FFINFutureReflection::StaticStruct()) Trace = future->Get<FFINFutureReflection>().Context.GetTrace();
-			for (const FFINAnyNetworkValue& Param : Data) networkValueToLua(L, Param, Trace);
-			return Data.Num();
+			return luaFuturePushOutput(L, future);
 		}
 
 		int luaFutureCanGet(lua_State* L) {
@@ -87,6 +132,25 @@ namespace FicsItKernel {
 			{nullptr, nullptr}
 		};
 
+		int luaFutureAll(lua_State* L) {
+			const int FutureCount = lua_gettop(L);
+			for (int i = 1; i <= FutureCount; ++i) luaL_checkudata(L, i, "Future");
+			return luaFutureAwaitContinue(L, LUA_OK, luaFutureAwaitContext(FUTURE_AWAIT_ALL, FutureCount));
+		}
+
+		int luaFutureAny(lua_State* L) {
+			const int FutureCount = lua_gettop(L);
+			luaL_argcheck(L, FutureCount > 0, 1, "expected at least one future");
+			for (int i = 1; i <= FutureCount; ++i) luaL_checkudata(L, i, "Future");
+			return luaFutureAwaitContinue(L, LUA_OK, luaFutureAwaitContext(FUTURE_AWAIT_ANY, FutureCount));
+		}
+
+		static const luaL_Reg luaFutureGlobalLib[] = {
+			{"all", luaFutureAll},
+			{"any", luaFutureAny},
+			{nullptr, nullptr}
+		};
+
 		static const luaL_Reg luaFutureMetaLib[] = {
 			{"__newindex", luaFutureNewIndex},
 			{"__gc", luaFutureGC},
@@ -117,6 +181,13 @@ namespace FicsItKernel {
 			lua_pop(L, 1);
 			lua_pushcfunction(L, luaFutureUnpersist);
 			PersistValue("FutureUnpersist");
+			lua_pushcfunction(L, (int(*)(lua_State*))luaFutureAwaitContinue);
+			PersistValue("FutureAwaitContinue");
+
+			lua_newtable(L);
+			luaL_setfuncs(L, luaFutureGlobalLib, 0);
+			PersistTable("Lib", -1);
+			lua_setglobal(L, "future");
 		}
 	}
 }
@@ -13,6 +13,7 @@
 #include "FicsItNetworks/Reflection/FINReflection.h"
 
 #define INSTANCE_TYPE "InstanceType"
+#define INSTANCE_CACHE "InstanceCache"
 
 #define OffsetParam(type, off) (type*)((std::uint64_t)param + off)
 
@@ -291,6 +292,10 @@ namespace FicsItKernel {
 			Kernel->AddReferencer(this, &CollectReferences);
 		}
 		
+		LuaInstance::LuaInstance(FFINNetworkTrace&& Trace, UFINKernelSystem* Kernel) : Trace(MoveTemp(Trace)), Kernel(Kernel) {
+			Kernel->AddReferencer(this, &CollectReferences);
+		}
+		
 		LuaInstance::LuaInstance(const LuaInstance& Other) : Trace(Other.Trace), Kernel(Other.Kernel) {
 			Kernel->AddReferencer(this, &CollectReferences);
 		}
@@ -303,11 +308,43 @@ namespace FicsItKernel {
 			static_cast<LuaInstance*>(Obj)->Trace.AddStructReferencedObjects(Collector);
 		}
 
-		bool newInstance(lua_State* L, const FFINNetworkTrace& Trace) {
-			// check obj and if type is registered
+		/**
+		 * Pushes the instance cache of the given lua state onto the stack.
+		 * The cache maps a key made of the object and the trace hash to the lua instance,
+		 * it only holds weak references to the instances so they still get collected if not used anymore.
+		 */
+		void luaGetInstanceCache(lua_State* L) {
+			if (!luaL_getsubtable(L, LUA_REGISTRYINDEX, INSTANCE_CACHE)) {				// ..., Cache
+				lua_createtable(L, 0, 1);												// ..., Cache, CacheMeta
+				lua_pushstring(L, "v");													// ..., Cache, CacheMeta, "v"
+				lua_setfield(L, -2, "__mode");											// ..., Cache, CacheMeta
+				lua_setmetatable(L, -2);												// ..., Cache
+			}
+		}
+
+		template<typename TraceType>
+		bool newInstanceImpl(lua_State* L, TraceType&& Trace) {
+			// check obj
 			UObject* Obj = Trace.GetUnderlyingPtr();
-			UFINClass* Class = nullptr;
-			if (IsValid(Obj)) Class = FFINReflection::Get()->FindClass(Obj->GetClass());
+			if (!IsValid(Obj)) {
+				lua_pushnil(L);
+				return false;
+			}
+
+			// try to reuse the instance of the same trace if it is still alive
+			const lua_Integer CacheKey = static_cast<lua_Integer>(reinterpret_cast<UPTRINT>(Obj) ^ (static_cast<uint64>(Trace.GetTraceHash()) << 32));
+			luaGetInstanceCache(L);																// ..., Cache
+			if (lua_rawgeti(L, -1, CacheKey) == LUA_TUSERDATA) {								// ..., Cache, CachedInstance
+				const LuaInstance* Cached = static_cast<LuaInstance*>(lua_touserdata(L, -1));
+				if (Cached->Trace.IsEqualTrace(Trace)) {
+					lua_remove(L, -2);															// ..., CachedInstance
+					return true;
+				}
+			}
+			lua_pop(L, 2);																		// ...
+
+			// check if type is registered
+			UFINClass* Class = FFINReflection::Get()->FindClass(Obj->GetClass());
 			if (!Class) {
 				lua_pushnil(L);
 				return false;
@@ -326,12 +363,26 @@ namespace FicsItKernel {
 			
 			// create instance
 			LuaInstance* Instance = static_cast<LuaInstance*>(lua_newuserdata(L, sizeof(LuaInstance)));
-			new (Instance) LuaInstance(Trace, UFINLuaProcessor::luaGetProcessor(L)->GetKernel());
+			new (Instance) LuaInstance(Forward<TraceType>(Trace), UFINLuaProcessor::luaGetProcessor(L)->GetKernel());
 			
 			luaL_setmetatable(L, TCHAR_TO_UTF8(*Name));
+
+			// remember instance for further lookups
+			luaGetInstanceCache(L);																// ..., Instance, Cache
+			lua_pushvalue(L, -2);																// ..., Instance, Cache, Instance
+			lua_rawseti(L, -2, CacheKey);														// ..., Instance, Cache
+			lua_pop(L, 1);																		// ..., Instance
 			return true;
 		}
 
+		bool newInstance(lua_State* L, const FFINNetworkTrace& Trace) {
+			return newInstanceImpl(L, Trace);
+		}
+
+		bool newInstance(lua_State* L, FFINNetworkTrace&& Trace) {
+			return newInstanceImpl(L, MoveTemp(Trace));
+		}
+
 		FFINNetworkTrace getObjInstance(lua_State* L, int index, UClass* clazz) {
 			if (lua_isnil(L, index)) return FFINNetworkTrace(nullptr);
 			LuaInstance* instance = CheckAndGetInstance(L, index);
@@ -22,6 +22,7 @@ namespace FicsItKernel {
 			FFINNetworkTrace Trace;
 			UFINKernelSystem* Kernel;
 			LuaInstance(const FFINNetworkTrace& Trace, UFINKernelSystem* Kernel);
+			LuaInstance(FFINNetworkTrace&& Trace, UFINKernelSystem* Kernel);
 			LuaInstance(const LuaInstance& Other);
 			~LuaInstance();
 			static void CollectReferences(void* Obj, FReferenceCollector& Collector);
@@ -51,6 +52,12 @@ namespace FicsItKernel {
 		 */
 		bool newInstance(lua_State* L, const FFINNetworkTrace& obj);
 
+		/**
+		 * Same as newInstance(lua_State*, const FFINNetworkTrace&), but moves the given trace into the instance
+		 * instead of copying it.
+		 */
+		bool newInstance(lua_State* L, FFINNetworkTrace&& obj);
+
 		/**
 		 * Trys to get a Lua Instance from the given lua stack at the given index of the given type.
 		 * If unable to find it returns an invalid network trace.
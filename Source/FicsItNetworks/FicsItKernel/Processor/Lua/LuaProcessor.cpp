@@ -4,6 +4,7 @@
 #include "LuaStructs.h"
 #include "LuaFileSystemAPI.h"
 #include "FINStateEEPROMLua.h"
+#include "LuaBytecodeCache.h"
 #include "LuaComponentAPI.h"
 #include "LuaComputerAPI.h"
 #include "LuaDebugAPI.h"
@@ -13,8 +14,12 @@
 #include "FicsItNetworks/Network/FINNetworkTrace.h"
 #include "FicsItNetworks/Network/FINNetworkUtils.h"
 #include "FicsItNetworks/Reflection/FINSignal.h"
+#include "FicsItNetworks/FicsItKernel/KernelTimerWheel.h"
+#include "Algo/AllOf.h"
+#include "Algo/AnyOf.h"
 
 #include "eris.h"
+#include "Misc/ScopeExit.h"
 
 void LuaFileSystemListener::onUnmounted(CodersFileSystem::Path path, CodersFileSystem::SRef<CodersFileSystem::Device> device) {
 	for (FicsItKernel::Lua::LuaFile file : Parent->GetFileStreams()) {
@@ -189,7 +194,7 @@ void FFINLuaProcessorTick::syncTick() {
 			bDoSync = false;
 			AsyncSyncMutex.Unlock();
 		} else {
-			if (asyncTask->IsDone() && (!WaitForSignal || Processor->GetKernel()->GetNetwork()->GetSignalCount() > 0 || Processor->PullTimeoutReached())) {
+			if (asyncTask->IsDone() && !Processor->IsAwaitingFutures() && (!WaitForSignal || Processor->GetKernel()->GetNetwork()->GetSignalCount() > 0 || Processor->PullTimeoutReached())) {
 				AsyncSyncMutex.Lock();
 				bWaitForSignal = false;
 				AsyncSyncMutex.Unlock();
@@ -224,7 +229,7 @@ bool FFINLuaProcessorTick::asyncTick() {
 			TickMutex.Unlock();
 			return false;
 		}
-		return !bWaitForSignal;
+		return !bWaitForSignal && !Processor->IsAwaitingFutures();
 	}
 	return false;
 }
@@ -301,10 +306,69 @@ int FFINLuaProcessorTick::steps() const {
 }
 
 UFINLuaProcessor* UFINLuaProcessor::luaGetProcessor(lua_State* L) {
+	// the extra space of the main thread gets copied to every thread created in the state
+	return *static_cast<UFINLuaProcessor**>(lua_getextraspace(L));
+}
+
+int luaBenchmarkRegistryLookup(lua_State* L) {
 	lua_getfield(L, LUA_REGISTRYINDEX, "LuaProcessorPtr");
 	UFINLuaProcessor* p = *static_cast<UFINLuaProcessor**>(luaL_checkudata(L, -1, "LuaProcessor"));
 	lua_pop(L, 1);
-	return p;
+	lua_pushboolean(L, p != nullptr);
+	return 1;
+}
+
+int luaBenchmarkExtraSpaceLookup(lua_State* L) {
+	lua_pushboolean(L, UFINLuaProcessor::luaGetProcessor(L) != nullptr);
+	return 1;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkLuaProcessorLookupCommand(
+	TEXT("FIN.BenchmarkLuaProcessorLookup"),
+	TEXT("Measures a tight Lua loop of API calls looking up the Lua processor through the registry and through the extra space of the state. Args: [Iterations=1000000]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World) {
+		int32 Iterations = 1000000;
+		if (Args.Num() > 0) Iterations = FMath::Max(1, FCString::Atoi(*Args[0]));
+
+		lua_State* L = luaL_newstate();
+		UFINLuaProcessor* Processor = GetMutableDefault<UFINLuaProcessor>();
+		*static_cast<UFINLuaProcessor**>(lua_getextraspace(L)) = Processor;
+		luaL_newmetatable(L, "LuaProcessor");
+		lua_pop(L, 1);
+		*static_cast<UFINLuaProcessor**>(lua_newuserdata(L, sizeof(UFINLuaProcessor*))) = Processor;
+		luaL_setmetatable(L, "LuaProcessor");
+		lua_setfield(L, LUA_REGISTRYINDEX, "LuaProcessorPtr");
+		lua_register(L, "registryLookup", luaBenchmarkRegistryLookup);
+		lua_register(L, "extraSpaceLookup", luaBenchmarkExtraSpaceLookup);
+
+		const auto Run = [L, Iterations](const char* Func) {
+			const FString Code = FString::Printf(TEXT("local f = %s for i = 1, %i do f() end"), UTF8_TO_TCHAR(Func), Iterations);
+			luaL_loadstring(L, TCHAR_TO_UTF8(*Code));
+			const double Start = FPlatformTime::Seconds();
+			lua_pcall(L, 0, 0, 0);
+			return (FPlatformTime::Seconds() - Start) * 1e9 / Iterations;
+		};
+		const double Registry = Run("registryLookup");
+		const double ExtraSpace = Run("extraSpaceLookup");
+		lua_close(L);
+		
+		UE_LOG(LogFicsItNetworks, Display, TEXT("Lua processor lookup benchmark with %i calls: %.2fns per call with registry lookup, %.2fns per call with extra space lookup"), Iterations, Registry, ExtraSpace);
+	}));
+
+int luaPanic(lua_State* L) {
+	const char* Msg = lua_tostring(L, -1);
+	UE_LOG(LogFicsItNetworks, Error, TEXT("Unprotected error in Lua: %s"), UTF8_TO_TCHAR(Msg ? Msg : "error object is not a string"));
+	return 0;
+}
+
+void luaWarn(void* ud, const char* msg, int tocont) {
+	FString& Warning = *static_cast<FString*>(ud);
+	if (Warning.IsEmpty() && !tocont && *msg == '@') return; // ignore control messages
+	Warning += UTF8_TO_TCHAR(msg);
+	if (!tocont) {
+		UE_LOG(LogFicsItNetworks, Warning, TEXT("Lua warning: %s"), *Warning);
+		Warning.Empty();
+	}
 }
 
 UFINLuaProcessor::UFINLuaProcessor() : tickHelper(this), FileSystemListener(new LuaFileSystemListener(this)) {
@@ -420,6 +484,20 @@ void UFINLuaProcessor::Serialize(FArchive& Ar) {
 void UFINLuaProcessor::BeginDestroy() {
 	Super::BeginDestroy();
 	tickHelper.stop();
+	ClearPullTimer();
+	
+	// the finalizers of the state unregister the instances living in the allocator memory from the kernel
+	CloseLuaState();
+	Allocator.Reset();
+}
+
+void UFINLuaProcessor::CloseLuaState() {
+	if (!luaState) return;
+	lua_close(luaState);
+	luaState = nullptr;
+	luaThread = nullptr;
+	luaThreadIndex = 0;
+	LuaWarning.Empty();
 }
 
 void UFINLuaProcessor::PostSaveGame_Implementation(int32 saveVersion, int32 gameVersion) {}
@@ -506,6 +584,13 @@ void UFINLuaProcessor::PostLoadGame_Implementation(int32 saveVersion, int32 game
 
 void UFINLuaProcessor::SetKernel(UFINKernelSystem* InKernel) {
 	if (GetKernel() && GetKernel()->GetFileSystem()) GetKernel()->GetFileSystem()->removeListener(FileSystemListener);
+	if (!InKernel && GetKernel()) {
+		// close the state while the kernel still exists, so the finalizers can unregister from it
+		tickHelper.stop();
+		ClearPullTimer();
+		CloseLuaState();
+		Allocator.Reset();
+	}
 	Kernel = InKernel;
 }
 
@@ -525,10 +610,20 @@ void UFINLuaProcessor::Stop(bool bIsCrash) {
 }
 
 void UFINLuaProcessor::LuaTick() {
+	// runtime waits for futures -> skip tick until the kernel resolved them
+	if (IsAwaitingFutures()) return;
+	
 	try {
 		// reset out of time
 		lua_sethook(luaThread, UFINLuaProcessor::luaHook, LUA_MASKCOUNT, tickHelper.steps());
 		
+		// the memory limit is only enforced while lua runs in protected mode, so exceeding it raises a lua error
+		const auto Resume = [this](int Args, int* Results) {
+			Allocator->SetEnforceLimit(true);
+			ON_SCOPE_EXIT { Allocator->SetEnforceLimit(false); };
+			return lua_resume(luaThread, luaState, Args, Results);
+		};
+		
 		int nres = -1;
 		int Status;
 		if (PullState != 0) {
@@ -536,6 +631,7 @@ void UFINLuaProcessor::LuaTick() {
 			if (GetKernel() && GetKernel()->GetNetwork() && GetKernel()->GetNetwork()->GetSignalCount() > 0) {
 				// Signal available -> reset timeout and pull signal from network
 				PullState = 0;
+				ClearPullTimer();
 				GetTickHelper().signalFound();
 				const int SigArgCount = DoSignal(luaThread);
 				if (SigArgCount < 1) {
@@ -543,7 +639,7 @@ void UFINLuaProcessor::LuaTick() {
 					Status = LUA_ERRRUN;
 				} else {
 					// signal popped -> resume yield with signal as parameters (passing signals parameters back to pull yield)
-					Status = lua_resume(luaThread, luaState, SigArgCount, &nres);
+					Status = Resume(SigArgCount, &nres);
 				}
 			} else if (PullState == 2 || !PullTimeoutReached()) {
 				// no signal available & not timeout reached -> skip tick
@@ -551,12 +647,13 @@ void UFINLuaProcessor::LuaTick() {
 			} else {
 				// no signal available & timeout reached -> resume yield with  no parameters
 				PullState = 0;
+				ClearPullTimer();
 				GetTickHelper().signalFound();
-				Status = lua_resume(luaThread, luaState, 0, &nres);
+				Status = Resume(0, &nres);
 			}
 		} else {
 			// resume runtime normally
-			Status = lua_resume(luaThread, luaState, 0, &nres);
+			Status = Resume(0, &nres);
 		}
 		if (Status == LUA_YIELD) {
 			// system yielded and waits for next tick
@@ -617,15 +714,24 @@ void UFINLuaProcessor::Reset() {
 	// reset temp-data
 	Timeout = -1;
 	PullState = 0;
+	ClearPullTimer();
+	{
+		FScopeLock Lock(&AwaitedFuturesMutex);
+		AwaitedFutures.Empty();
+		bAwaitingFutures = false;
+	}
 	GetKernel()->GetFileSystem()->addListener(FileSystemListener);
 
 	// clear existing lua state
-	if (luaState) {
-		lua_close(luaState);
-	}
+	CloseLuaState();
 
-	// create new lua state
-	luaState = luaL_newstate();
+	// create new lua state, the allocator of the old state gets freed after the state got closed
+	Allocator = MakeUnique<FicsItKernel::Lua::FLuaPoolAllocator>();
+	SetMemoryBudget(MemoryBudget >= 0 ? MemoryBudget : GetKernel()->GetCapacity());
+	luaState = lua_newstate(&FicsItKernel::Lua::FLuaPoolAllocator::LuaAlloc, Allocator.Get());
+	lua_atpanic(luaState, &luaPanic);
+	lua_setwarnf(luaState, &luaWarn, &LuaWarning);
+	*static_cast<UFINLuaProcessor**>(lua_getextraspace(luaState)) = this;
 
 	// setup library and perm tables for persistence
 	lua_newtable(luaState); // perm
@@ -660,10 +766,7 @@ void UFINLuaProcessor::Reset() {
 		Kernel->Crash(MakeShared<FFINKernelCrash>("No Valid EEPROM set"));
 		return;
 	}
-	const FTCHARToUTF8 CodeConv(*EEPROM->GetCode(), EEPROM->GetCode().Len());
-	const std::string code = std::string(CodeConv.Get(), CodeConv.Length());
-	luaL_loadbuffer(luaThread, code.c_str(), code.size(), "=EEPROM");
-	if (lua_isstring(luaThread, -1)) {
+	if (FicsItKernel::Lua::FLuaBytecodeCache::Get().Load(luaThread, EEPROM->GetCode(), "=EEPROM") != LUA_OK) {
 		// Syntax error
 		Kernel->Crash(MakeShared<FFINKernelCrash>(lua_tostring(luaThread, -1)));
 		return;
@@ -680,6 +783,16 @@ int64 UFINLuaProcessor::GetMemoryUsage(bool bInRecalc) {
 	return lua_gc(luaState, LUA_GCCOUNT, 0)* 100;
 }
 
+void UFINLuaProcessor::SetMemoryBudget(int64 InBudget) {
+	MemoryBudget = InBudget;
+	// memory usage counts 100 per kilobyte of the lua state
+	if (Allocator) Allocator->SetLimit(FMath::Max<int64>(InBudget, 0) / 100 * 1024);
+}
+
+const FicsItKernel::Lua::FLuaPoolAllocator* UFINLuaProcessor::GetAllocator() const {
+	return Allocator.Get();
+}
+
 void UFINLuaProcessor::SetEEPROM(AFINStateEEPROM* InEEPROM) {
 	EEPROM = Cast<AFINStateEEPROMLua>(InEEPROM);
 }
@@ -692,8 +805,55 @@ FFINLuaProcessorTick& UFINLuaProcessor::GetTickHelper() {
 	return tickHelper;
 }
 
+void UFINLuaProcessor::HandleFutures() {
+	if (!bAwaitingFutures) return;
+	FScopeLock Lock(&AwaitedFuturesMutex);
+	const auto IsDone = [](const TSharedPtr<TFINDynamicStruct<FFINFuture>>& Future) {
+		return (*Future)->IsDone();
+	};
+	if (bAwaitAllFutures ? Algo::AllOf(AwaitedFutures, IsDone) : Algo::AnyOf(AwaitedFutures, IsDone)) {
+		// futures resolved -> runtime is runnable again
+		AwaitedFutures.Empty();
+		bAwaitingFutures = false;
+	}
+}
+
+void UFINLuaProcessor::AwaitFutures(const TArray<TSharedPtr<TFINDynamicStruct<FFINFuture>>>& Futures, bool bAll) {
+	FScopeLock Lock(&AwaitedFuturesMutex);
+	AwaitedFutures = Futures;
+	bAwaitAllFutures = bAll;
+	bAwaitingFutures = true;
+}
+
+bool UFINLuaProcessor::IsAwaitingFutures() const {
+	return bAwaitingFutures;
+}
+
 bool UFINLuaProcessor::PullTimeoutReached() {
-	return Timeout <= (static_cast<double>((FDateTime::Now() - FFicsItNetworksModule::GameStart).GetTotalMilliseconds() - PullStart) / 1000.0);
+	FScopeLock Lock(&PullTimerMutex);
+	return bPullTimeoutReached;
+}
+
+void UFINLuaProcessor::StartPullTimer() {
+	ClearPullTimer();
+	FScopeLock Lock(&PullTimerMutex);
+	const int64 Deadline = FFicsItNetworksModule::GetGameMillis() + static_cast<int64>(FMath::Max(Timeout, 0.0) * 1000.0);
+	const uint64 Generation = ++PullTimerGeneration;
+	TWeakObjectPtr<UFINLuaProcessor> WeakThis = this;
+	PullTimer = FFINKernelTimerWheel::Get().AddTimer(Deadline, [WeakThis, Generation]() {
+		UFINLuaProcessor* Processor = WeakThis.Get();
+		if (!Processor) return;
+		// the timer might have been cleared or replaced while the wheel fired it
+		FScopeLock Lock(&Processor->PullTimerMutex);
+		if (Processor->PullTimer && Processor->PullTimerGeneration == Generation) Processor->bPullTimeoutReached = true;
+	});
+}
+
+void UFINLuaProcessor::ClearPullTimer() {
+	FScopeLock Lock(&PullTimerMutex);
+	if (PullTimer) FFINKernelTimerWheel::Get().RemoveTimer(PullTimer);
+	PullTimer = 0;
+	bPullTimeoutReached = false;
 }
 
 int luaReYield(lua_State* L) {
@@ -702,27 +862,23 @@ int luaReYield(lua_State* L) {
 }
 
 int luaPrint(lua_State* L) {
-	// ReSharper disable once CppDeclaratorNeverUsed
-	FLuaSyncCall SyncCall(L);
 	const int args = lua_gettop(L);
-	std::string log;
 	for (int i = 1; i <= args; ++i) {
-		size_t s_len = 0;
-		const char* s = luaL_tolstring(L, i, &s_len);
-		if (!s) luaL_argerror(L, i, "is not valid type");
-		log += std::string(s, s_len) + " ";
+		if (!luaL_tolstring(L, i, nullptr)) luaL_argerror(L, i, "is not valid type");
 	}
-	if (log.length() > 0) log = log.erase(log.length()-1);
 	
-	try {
-		UFINLuaProcessor* Processor = UFINLuaProcessor::luaGetProcessor(L);
-		CodersFileSystem::SRef<CodersFileSystem::FileStream> serial = Processor->GetKernel()->GetDevDevice()->getSerial()->open(CodersFileSystem::OUTPUT);
-		if (serial) {
-			*serial << log << "\r\n";
-			serial->close();
+	// the serial output is guarded by its own lock, no need to sync with the game thread
+	UFINLuaProcessor* Processor = UFINLuaProcessor::luaGetProcessor(L);
+	CodersFileSystem::SRef<FFINKernelFSDevDevice> DevDevice = Processor->GetKernel()->GetDevDevice();
+	if (DevDevice && DevDevice->getSerial()) {
+		CodersFileSystem::SRef<FFINKernelFSSerial> Serial = DevDevice->getSerial();
+		for (int i = 1; i <= args; ++i) {
+			size_t s_len = 0;
+			const char* s = lua_tolstring(L, args + i, &s_len);
+			if (i > 1) Serial->writeOutput(" ", 1);
+			Serial->writeOutput(s, s_len);
 		}
-	} catch (std::exception ex) {
-		luaL_error(L, ex.what());
+		Serial->writeOutput("\r\n", 2);
 	}
 	
 	return UFINLuaProcessor::luaAPIReturn(L, 0);
@@ -951,15 +1107,10 @@ int UFINLuaProcessor::DoSignal(lua_State* L) {
 	if (!net || net->GetSignalCount() < 1) return 0;
 	FFINNetworkTrace sender;
 	FFINSignalData signal = net->PopSignal(sender); 
-	int props = 2;
 	if (signal.Signal) lua_pushstring(L, TCHAR_TO_UTF8(*signal.Signal->GetInternalName()));
 	else lua_pushnil(L);
 	FicsItKernel::Lua::newInstance(L, UFINNetworkUtils::RedirectIfPossible(sender));
-	for (const FFINAnyNetworkValue& Value : signal.Data) {
-		FicsItKernel::Lua::networkValueToLua(L, Value, sender);
-		props++;
-	}
-	return props;
+	return 2 + FicsItKernel::Lua::networkValuesToLua(L, signal.Data, sender);
 }
 
 void UFINLuaProcessor::luaHook(lua_State* L, lua_Debug* ar) {
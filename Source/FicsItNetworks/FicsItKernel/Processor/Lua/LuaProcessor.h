@@ -4,6 +4,7 @@
 #include "FicsItNetworks/FicsItKernel/Processor/Processor.h"
 #include "FicsItNetworks/FicsItKernel/FicsItKernel.h"
 #include "LuaFileSystemAPI.h"
+#include "LuaAllocator.h"
 #include "LuaProcessor.generated.h"
 
 class AFINStateEEPROMLua;
@@ -130,11 +131,20 @@ private:
 	TWeakObjectPtr<AFINStateEEPROMLua> EEPROM;
 
 	// Lua runtime
+	TUniquePtr<FicsItKernel::Lua::FLuaPoolAllocator> Allocator;
+	int64 MemoryBudget = -1;
 	lua_State* luaState = nullptr;
 	lua_State* luaThread = nullptr;
 	int luaThreadIndex = 0;
+	FString LuaWarning;
 	FFINLuaProcessorTick tickHelper;
 
+	/**
+	 * Closes the lua state if there is one, which runs the finalizers of all remaining objects.
+	 * Has to happen before the allocator of the state gets released.
+	 */
+	void CloseLuaState();
+
 	// signal pulling
 	UPROPERTY(SaveGame)
 	int PullState = 0; // 0 = not pulling, 1 = pulling with timeout, 2 = pull indefinitely
@@ -142,6 +152,16 @@ private:
 	double Timeout = 0.0;
 	UPROPERTY(SaveGame)
 	uint64 PullStart = 0;
+	uint64 PullTimer = 0;
+	uint64 PullTimerGeneration = 0;
+	bool bPullTimeoutReached = false;
+	FCriticalSection PullTimerMutex;
+
+	// future awaiting
+	TArray<TSharedPtr<TFINDynamicStruct<FFINFuture>>> AwaitedFutures;
+	bool bAwaitAllFutures = false;
+	FThreadSafeBool bAwaitingFutures = false;
+	FCriticalSection AwaitedFuturesMutex;
 
 	// filesystem handling
 	TSet<FicsItKernel::Lua::LuaFile> FileStreams;
@@ -174,7 +194,9 @@ public:
 	virtual void Stop(bool bInIsCrash) override;
 	virtual void Reset() override;
 	virtual int64 GetMemoryUsage(bool bInRecalc = false) override;
+	virtual void SetMemoryBudget(int64 InBudget) override;
 	virtual void SetEEPROM(AFINStateEEPROM* InEEPROM) override;
+	virtual void HandleFutures() override;
 	// End Processor
 
 	/**
@@ -186,6 +208,31 @@ public:
 	 * Checks if the pull timeout has been reached
 	 */
 	bool PullTimeoutReached();
+
+	/**
+	 * Adds a timer for the current pull timeout to the timer wheel,
+	 * replaces the timer of a previous pull.
+	 */
+	void StartPullTimer();
+
+	/**
+	 * Removes the timer of the current pull from the timer wheel
+	 */
+	void ClearPullTimer();
+
+	/**
+	 * Parks the runtime until the given futures are done.
+	 * The runtime doesn't get resumed until the kernel resolved the futures in HandleFutures.
+	 *
+	 * @param[in]	Futures		the futures the runtime waits for
+	 * @param[in]	bAll		true if all futures have to be done, false if any of them is enough
+	 */
+	void AwaitFutures(const TArray<TSharedPtr<TFINDynamicStruct<FFINFuture>>>& Futures, bool bAll);
+
+	/**
+	 * Checks if the runtime is parked and waits for futures to get done
+	 */
+	bool IsAwaitingFutures() const;
 	
 	/**
 	 * Executes one lua tick sync or async.
@@ -237,6 +284,11 @@ public:
 	 */
 	static int luaAPIReturn(lua_State* L, int args);
 
+	/**
+	 * Returns the allocator of the lua state, nullptr if no state got created yet
+	 */
+	const FicsItKernel::Lua::FLuaPoolAllocator* GetAllocator() const;
+
 	/**
 	 * Returns the lua state
 	 */
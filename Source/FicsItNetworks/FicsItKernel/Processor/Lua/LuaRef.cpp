@@ -53,10 +53,7 @@ namespace FicsItKernel {
 				}
 
 				// push output onto lua stack
-				for (const FINAny& Value : Output) {
-					networkValueToLua(L, Value, Ctx.GetTrace());
-					++args;
-				}
+				args = networkValuesToLua(L, Output, Ctx.GetTrace());
 			}
 			
 			return UFINLuaProcessor::luaAPIReturn(L, args);
@@ -21,6 +21,22 @@ namespace FicsItKernel {
 		TMap<UFINStruct*, FString> StructToMetaName;
 		TMap<FString, UFINStruct*> MetaNameToStruct;
 		FCriticalSection StructMetaNameLock;
+
+		bool luaIsInlineStruct(UFINStruct* Type) {
+			UScriptStruct* Struct = Cast<UScriptStruct>(Type->GetOuter());
+			return Struct && (Struct->StructFlags & STRUCT_IsPlainOldData) && !Struct->RefLink;
+		}
+
+		/**
+		 * Creates a new uninitialized inline struct userdata of the given type and pushes it onto the stack.
+		 * The metatable still has to be set.
+		 */
+		LuaInlineStruct* luaNewInlineStruct(lua_State* L, UFINStruct* Type, UScriptStruct* Struct) {
+			LuaInlineStruct* LStruct = static_cast<LuaInlineStruct*>(lua_newuserdatauv(L, sizeof(LuaInlineStruct) + Struct->GetStructureSize(), 0));
+			LStruct->Type = Type;
+			LStruct->Struct = Struct;
+			return LStruct;
+		}
 		
 		TSharedPtr<FINStruct> luaGetStruct(lua_State* L, int i, LuaStruct** LStructPtr) {
 			UFINStruct* Type = luaGetStructType(L, i);
@@ -55,6 +71,11 @@ namespace FicsItKernel {
 				StructMetaNameLock.Lock();
 				FString MetaName = StructToMetaName[Type];
 				StructMetaNameLock.Unlock();
+				if (luaIsInlineStruct(Type)) {
+					LuaInlineStruct* LStruct = static_cast<LuaInlineStruct*>(luaL_checkudata(L, i, TCHAR_TO_UTF8(*MetaName)));
+					LStruct->Struct->CopyScriptStruct(Struct->GetData(), LStruct->GetData());
+					return nullptr;
+				}
 				LuaStruct* LStruct = static_cast<LuaStruct*>(luaL_checkudata(L, i, TCHAR_TO_UTF8(*MetaName)));
 				Struct = LStruct->Struct;
 				return LStruct;
@@ -87,8 +108,15 @@ namespace FicsItKernel {
 				return;
 			}
 			setupStructMetatable(L, Type);
-			LuaStruct* LStruct = static_cast<LuaStruct*>(lua_newuserdata(L, sizeof(LuaStruct)));
-			new (LStruct) LuaStruct(Type, Struct, UFINLuaProcessor::luaGetProcessor(L)->GetKernel());
+			if (luaIsInlineStruct(Type)) {
+				// derived structs get sliced to the reflected type
+				UScriptStruct* ScriptStruct = Cast<UScriptStruct>(Type->GetOuter());
+				LuaInlineStruct* LStruct = luaNewInlineStruct(L, Type, ScriptStruct);
+				FMemory::Memcpy(LStruct->GetData(), Struct.GetData(), ScriptStruct->GetStructureSize());
+			} else {
+				LuaStruct* LStruct = static_cast<LuaStruct*>(lua_newuserdata(L, sizeof(LuaStruct)));
+				new (LStruct) LuaStruct(Type, Struct, UFINLuaProcessor::luaGetProcessor(L)->GetKernel());
+			}
 			luaL_setmetatable(L, TCHAR_TO_UTF8(*StructToMetaName[Type]));
 		}
 
@@ -120,11 +148,16 @@ namespace FicsItKernel {
 			}
 			const FString MetaName = *MetaNamePtr;
 			StructMetaNameLock.Unlock();
-			LuaStruct* Instance = static_cast<LuaStruct*>(luaL_checkudata(L, 1, TCHAR_TO_UTF8(*MetaName)));
-			if (!Instance->Struct->GetData()) return luaL_argerror(L, 1, "Struct is invalid");
+			void* Data;
+			if (luaIsInlineStruct(Cast<UFINStruct>(Func->Struct))) {
+				Data = static_cast<LuaInlineStruct*>(luaL_checkudata(L, 1, TCHAR_TO_UTF8(*MetaName)))->GetData();
+			} else {
+				Data = static_cast<LuaStruct*>(luaL_checkudata(L, 1, TCHAR_TO_UTF8(*MetaName)))->Struct->GetData();
+			}
+			if (!Data) return luaL_argerror(L, 1, "Struct is invalid");
 
 			// call the function
-			return luaCallFINFunc(L, Func->Func, FFINExecutionContext(Instance->Struct->GetData()), "Struct");
+			return luaCallFINFunc(L, Func->Func, FFINExecutionContext(Data), "Struct");
 		}
 		
 		int luaStructIndex(lua_State* L) {
@@ -164,8 +197,8 @@ namespace FicsItKernel {
 
 		int luaStructEQ(lua_State* L) {
 			const TSharedPtr<FINStruct> Struct1 = luaGetStruct(L, 1);
-			const TSharedPtr<FINStruct> Struct2 = luaGetStruct(L, 1);
-			if (!Struct1->GetData() || !Struct2->GetData() || Struct1->GetStruct() != Struct2->GetStruct()) {
+			const TSharedPtr<FINStruct> Struct2 = luaGetStruct(L, 2);
+			if (!Struct1.IsValid() || !Struct2.IsValid() || !Struct1->GetData() || !Struct2->GetData() || Struct1->GetStruct() != Struct2->GetStruct()) {
 				lua_pushboolean(L, false);
 				return UFINLuaProcessor::luaAPIReturn(L, 1);
 			}
@@ -176,8 +209,8 @@ namespace FicsItKernel {
 
 		int luaStructLt(lua_State* L) {
 			const TSharedPtr<FINStruct> Struct1 = luaGetStruct(L, 1);
-			const TSharedPtr<FINStruct> Struct2 = luaGetStruct(L, 1);
-			if (!Struct1->GetData() || !Struct2->GetData() || Struct1->GetStruct() != Struct2->GetStruct()) {
+			const TSharedPtr<FINStruct> Struct2 = luaGetStruct(L, 2);
+			if (!Struct1.IsValid() || !Struct2.IsValid() || !Struct1->GetData() || !Struct2->GetData() || Struct1->GetStruct() != Struct2->GetStruct()) {
 				lua_pushboolean(L, false);
 				return UFINLuaProcessor::luaAPIReturn(L, 1);
 			}
@@ -188,8 +221,8 @@ namespace FicsItKernel {
 
 		int luaStructLe(lua_State* L) {
 			const TSharedPtr<FINStruct> Struct1 = luaGetStruct(L, 1);
-			const TSharedPtr<FINStruct> Struct2 = luaGetStruct(L, 1);
-			if (!Struct1->GetData() || !Struct2->GetData() || Struct1->GetStruct() != Struct2->GetStruct()) {
+			const TSharedPtr<FINStruct> Struct2 = luaGetStruct(L, 2);
+			if (!Struct1.IsValid() || !Struct2.IsValid() || !Struct1->GetData() || !Struct2->GetData() || Struct1->GetStruct() != Struct2->GetStruct()) {
 				lua_pushboolean(L, false);
 				return UFINLuaProcessor::luaAPIReturn(L, 1);
 			}
@@ -247,6 +280,115 @@ namespace FicsItKernel {
 			return 0;
 		}
 
+		int luaInlineStructIndex(lua_State* L) {
+			// the metatable is protected, so the first argument is always an inline struct
+			LuaInlineStruct* Struct = static_cast<LuaInlineStruct*>(lua_touserdata(L, 1));
+			const FString MemberName = lua_tostring(L, 2);
+			return luaFindGetMember(L, Struct->Type, FFINExecutionContext(Struct->GetData()), MemberName, Struct->Type->GetInternalName() + "_" + MemberName, &luaStructFuncCall, false);
+		}
+
+		int luaInlineStructNewIndex(lua_State* L) {
+			LuaInlineStruct* Struct = static_cast<LuaInlineStruct*>(lua_touserdata(L, 1));
+			const FString MemberName = lua_tostring(L, 2);
+			return luaFindSetMember(L, Struct->Type, FFINExecutionContext(Struct->GetData()), MemberName, false);
+		}
+
+		/**
+		 * Checks if the two operands of a metamethod are compatible,
+		 * if both are userdata, they have to share the same metatable (and so are of the same struct type).
+		 * If only one is userdata, it has to be the struct the metamethod got called for.
+		 */
+		bool luaCheckInlineStructOperands(lua_State* L) {
+			if (lua_type(L, 1) != LUA_TUSERDATA || lua_type(L, 2) != LUA_TUSERDATA) return true;
+			if (!lua_getmetatable(L, 1)) return false;
+			if (!lua_getmetatable(L, 2)) {
+				lua_pop(L, 1);
+				return false;
+			}
+			const bool bEqual = lua_rawequal(L, -1, -2);
+			lua_pop(L, 2);
+			return bEqual;
+		}
+
+		int luaInlineStructEQ(lua_State* L) {
+			if (!luaCheckInlineStructOperands(L)) {
+				lua_pushboolean(L, false);
+				return 1;
+			}
+			LuaInlineStruct* Struct1 = static_cast<LuaInlineStruct*>(lua_touserdata(L, 1));
+			LuaInlineStruct* Struct2 = static_cast<LuaInlineStruct*>(lua_touserdata(L, 2));
+			lua_pushboolean(L, Struct1->Struct->CompareScriptStruct(Struct1->GetData(), Struct2->GetData(), 0));
+			return 1;
+		}
+
+		template<typename T>
+		T* luaToInlineStructValue(lua_State* L, int i) {
+			if (lua_type(L, i) != LUA_TUSERDATA) return nullptr;
+			return static_cast<T*>(static_cast<LuaInlineStruct*>(lua_touserdata(L, i))->GetData());
+		}
+
+		/**
+		 * Pushes a new inline struct with the given value and the type and metatable of the struct at the given index.
+		 */
+		template<typename T>
+		int luaPushInlineStructValue(lua_State* L, int Like, const T& Value) {
+			const LuaInlineStruct* Source = static_cast<LuaInlineStruct*>(lua_touserdata(L, Like));
+			LuaInlineStruct* LStruct = luaNewInlineStruct(L, Source->Type, Source->Struct);
+			*static_cast<T*>(LStruct->GetData()) = Value;
+			lua_getmetatable(L, Like);
+			lua_setmetatable(L, -2);
+			return 1;
+		}
+
+		template<typename T>
+		int luaInlineStructAdd(lua_State* L) {
+			T* A = luaToInlineStructValue<T>(L, 1);
+			T* B = luaToInlineStructValue<T>(L, 2);
+			if (!A || !B || !luaCheckInlineStructOperands(L)) return luaL_error(L, "attempt to add incompatible values to a struct");
+			return luaPushInlineStructValue<T>(L, 1, *A + *B);
+		}
+
+		template<typename T>
+		int luaInlineStructSub(lua_State* L) {
+			T* A = luaToInlineStructValue<T>(L, 1);
+			T* B = luaToInlineStructValue<T>(L, 2);
+			if (!A || !B || !luaCheckInlineStructOperands(L)) return luaL_error(L, "attempt to subtract incompatible values from a struct");
+			return luaPushInlineStructValue<T>(L, 1, *A - *B);
+		}
+
+		template<typename T>
+		int luaInlineStructMul(lua_State* L) {
+			if (!luaCheckInlineStructOperands(L)) return luaL_error(L, "attempt to multiply incompatible structs");
+			T* A = luaToInlineStructValue<T>(L, 1);
+			T* B = luaToInlineStructValue<T>(L, 2);
+			if (A && lua_isnumber(L, 2)) return luaPushInlineStructValue<T>(L, 1, *A * static_cast<float>(lua_tonumber(L, 2)));
+			if (B && lua_isnumber(L, 1)) return luaPushInlineStructValue<T>(L, 2, *B * static_cast<float>(lua_tonumber(L, 1)));
+			if constexpr (!std::is_same_v<T, FRotator>) {
+				// rotators don't support component-wise multiplication
+				if (A && B) return luaPushInlineStructValue<T>(L, 1, *A * *B);
+			}
+			return luaL_error(L, "attempt to multiply a struct with an incompatible value");
+		}
+
+		template<typename T>
+		int luaInlineStructUnm(lua_State* L) {
+			T* A = luaToInlineStructValue<T>(L, 1);
+			if (!A) return luaL_error(L, "attempt to negate an invalid struct");
+			return luaPushInlineStructValue<T>(L, 1, *A * -1.0f);
+		}
+
+		template<typename T>
+		void luaSetupInlineStructArithmetic(lua_State* L) {
+			static const luaL_Reg Lib[] = {
+				{"__add", luaInlineStructAdd<T>},
+				{"__sub", luaInlineStructSub<T>},
+				{"__mul", luaInlineStructMul<T>},
+				{"__unm", luaInlineStructUnm<T>},
+				{NULL, NULL}
+			};
+			luaL_setfuncs(L, Lib, 0);
+		}
+
 		static const luaL_Reg luaStructLib[] = {
 			{"__index", luaStructIndex},
 			{"__newindex", luaStructNewIndex},
@@ -259,6 +401,17 @@ namespace FicsItKernel {
 			{NULL, NULL}
 		};
 
+		static const luaL_Reg luaInlineStructLib[] = {
+			{"__index", luaInlineStructIndex},
+			{"__newindex", luaInlineStructNewIndex},
+			{"__eq", luaInlineStructEQ},
+			{"__lt", luaStructLt},
+			{"__le", luaStructLe},
+			{"__tostring", luaStructToString},
+			{"__persist", luaStructPersist},
+			{NULL, NULL}
+		};
+
 		void setupStructSystem(lua_State* L) {
 			PersistSetup("StructSystem", -2);
 			
@@ -284,7 +437,16 @@ namespace FicsItKernel {
 			luaL_newmetatable(L, TCHAR_TO_UTF8(*TypeName));							// ..., InstanceMeta
 			lua_pushboolean(L, true);
 			lua_setfield(L, -2, "__metatable");
-			luaL_setfuncs(L, luaStructLib, 0);
+			if (luaIsInlineStruct(Struct)) {
+				luaL_setfuncs(L, luaInlineStructLib, 0);
+				UScriptStruct* ScriptStruct = Cast<UScriptStruct>(Struct->GetOuter());
+				if (ScriptStruct == TBaseStructure<FVector>::Get()) luaSetupInlineStructArithmetic<FVector>(L);
+				else if (ScriptStruct == TBaseStructure<FVector2D>::Get()) luaSetupInlineStructArithmetic<FVector2D>(L);
+				else if (ScriptStruct == TBaseStructure<FRotator>::Get()) luaSetupInlineStructArithmetic<FRotator>(L);
+				else if (ScriptStruct == TBaseStructure<FLinearColor>::Get()) luaSetupInlineStructArithmetic<FLinearColor>(L);
+			} else {
+				luaL_setfuncs(L, luaStructLib, 0);
+			}
 			lua_newtable(L);															// ..., InstanceMeta, InstanceCache
 			lua_setfield(L, -2, LUA_REF_CACHE);									// ..., InstanceMeta
 			PersistTable(TCHAR_TO_UTF8(*TypeName), -1);
@@ -20,6 +20,26 @@ namespace FicsItKernel {
 			~LuaStruct();
 			static void CollectReferences(void* Obj, FReferenceCollector& Collector);
 		};
+
+		/**
+		 * Header of a plain-data struct (like vectors and colors) stored inline in the userdata.
+		 * The struct data directly follows the header.
+		 * As the struct doesn't reference any objects, it needs no struct holder and no GC referencer.
+		 */
+		struct LuaInlineStruct {
+			UFINStruct* Type = nullptr;
+			UScriptStruct* Struct = nullptr;
+			
+			void* GetData() {
+				return this + 1;
+			}
+		};
+
+		/**
+		 * Returns true if structs of the given type get stored inline in the userdata
+		 * because they are plain-old-data without any object references.
+		 */
+		bool luaIsInlineStruct(UFINStruct* Type);
 		
 		/**
 		 * Trys to push the given struct onto the lua stack.
@@ -34,6 +54,8 @@ namespace FicsItKernel {
 		 * back to a struct of the type already set in the holder.
 		 * If no type is set or unable to convert the lua value to a struct,
 		 * throws a lua argument error.
+		 * Returns the lua struct if the holder now references the data of a userdata struct,
+		 * nullptr if the data got copied to the holder (f.e. for tables and inline structs).
 		 */
 		LuaStruct* luaGetStruct(lua_State* L, int i, TSharedRef<FINStruct>& Struct);
 
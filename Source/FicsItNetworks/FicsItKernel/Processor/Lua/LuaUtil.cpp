@@ -251,15 +251,10 @@ namespace FicsItKernel {
 					luaStruct(L, Val.GetStruct());
 				}
 				break;
-			} case FIN_ARRAY: {
-				lua_newtable(L);
-				int i = 0;
-				for (const FFINAnyNetworkValue& Entry : Val.GetArray()) {
-					networkValueToLua(L, Entry, Trace);
-					lua_seti(L, -2, ++i);
-				}
+			} case FIN_ARRAY:
+				networkArrayToLua(L, Val.GetArray(), Trace);
 				break;
-			} case FIN_ANY:
+			case FIN_ANY:
 				networkValueToLua(L, Val.GetAny(), Trace);
 				lua_pushnil(L);
 				break;
@@ -267,5 +262,82 @@ namespace FicsItKernel {
 				lua_pushnil(L);
 			}
 		}
+
+		int networkValuesToLua(lua_State* L, const TArray<FFINAnyNetworkValue>& Values, const FFINNetworkTrace& Trace) {
+			luaL_checkstack(L, Values.Num(), "too many values to return");
+			for (const FFINAnyNetworkValue& Value : Values) {
+				networkValueToLua(L, Value, Trace);
+			}
+			return Values.Num();
+		}
+
+		void networkArrayToLua(lua_State* L, const TArray<FFINAnyNetworkValue>& Array, const FFINNetworkTrace& Trace) {
+			const int Num = Array.Num();
+			lua_createtable(L, Num, 0);
+			if (Num < 1) return;
+
+			const EFINNetworkValueType Type = Array[0].GetType();
+			for (const FFINAnyNetworkValue& Entry : Array) {
+				if (Entry.GetType() != Type) {
+					// mixed array, convert entry by entry
+					for (int i = 0; i < Num; ++i) {
+						networkValueToLua(L, Array[i], Trace);
+						lua_rawseti(L, -2, i+1);
+					}
+					return;
+				}
+			}
+
+			switch (Type) {
+			case FIN_INT:
+				for (int i = 0; i < Num; ++i) {
+					lua_pushinteger(L, Array[i].GetInt());
+					lua_rawseti(L, -2, i+1);
+				}
+				break;
+			case FIN_FLOAT:
+				for (int i = 0; i < Num; ++i) {
+					lua_pushnumber(L, Array[i].GetFloat());
+					lua_rawseti(L, -2, i+1);
+				}
+				break;
+			case FIN_STR:
+				for (int i = 0; i < Num; ++i) {
+					const FString& Str = Array[i].GetString();
+					FTCHARToUTF8 Conv(*Str, Str.Len());
+					lua_pushlstring(L, Conv.Get(), Conv.Length());
+					lua_rawseti(L, -2, i+1);
+				}
+				break;
+			case FIN_OBJ: {
+				TArray<UObject*> Objects;
+				Objects.Reserve(Num);
+				for (const FFINAnyNetworkValue& Entry : Array) {
+					Objects.Add(Entry.GetObj().Get());
+				}
+				TArray<FFINNetworkTrace> Traces = Trace.AppendAll(Objects);
+				for (int i = 0; i < Num; ++i) {
+					newInstance(L, MoveTemp(Traces[i]));
+					lua_rawseti(L, -2, i+1);
+				}
+				break;
+			} case FIN_TRACE:
+				for (int i = 0; i < Num; ++i) {
+					newInstance(L, Array[i].GetTrace());
+					lua_rawseti(L, -2, i+1);
+				}
+				break;
+			default:
+				for (int i = 0; i < Num; ++i) {
+					networkValueToLua(L, Array[i], Trace);
+					lua_rawseti(L, -2, i+1);
+				}
+			}
+		}
+
+		int luaChunkWriter(lua_State* L, const void* p, size_t sz, void* ud) {
+			static_cast<std::string*>(ud)->append(static_cast<const char*>(p), sz);
+			return 0;
+		}
 	}
 }
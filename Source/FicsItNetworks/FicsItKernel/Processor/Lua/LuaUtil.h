@@ -111,5 +111,25 @@ namespace FicsItKernel {
 		 * Converts the given network value into a lua value and pushes it onto the stack
 		 */
 		void networkValueToLua(lua_State* L, const FFINAnyNetworkValue& Val, const FFINNetworkTrace& Trace);
+
+		/**
+		 * Converts the given network values into lua values and pushes all of them onto the stack.
+		 * Ensures the stack is large enough for all values at once.
+		 * @return the count of pushed values
+		 */
+		int networkValuesToLua(lua_State* L, const TArray<FFINAnyNetworkValue>& Values, const FFINNetworkTrace& Trace);
+
+		/**
+		 * Converts the given array of network values into a lua sequence and pushes it onto the stack.
+		 * The table gets pre-sized and arrays of only integers, floats, strings, objects or traces
+		 * get converted without checking the type of each entry.
+		 * Objects of the array share the given trace as prefix of their traces.
+		 */
+		void networkArrayToLua(lua_State* L, const TArray<FFINAnyNetworkValue>& Array, const FFINNetworkTrace& Trace);
+
+		/**
+		 * lua_Writer appending the dumped chunk to the std::string given as user data
+		 */
+		int luaChunkWriter(lua_State* L, const void* p, size_t sz, void* ud);
 	}
 }
\ No newline at end of file
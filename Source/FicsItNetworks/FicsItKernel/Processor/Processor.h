@@ -68,6 +68,14 @@ public:
 	 */
 	virtual int64 GetMemoryUsage(bool InRecalc = false) { return 0; }
 
+	/**
+	 * Sets the amount of memory the processor is allowed to use,
+	 * the capacity of the kernel minus the memory used by other system components.
+	 *
+	 * @param[in]	InBudget	the memory budget in the units of GetMemoryUsage
+	 */
+	virtual void SetMemoryBudget(int64 InBudget) {}
+
 	/**
 	 * Resets the execution state of the processor.
 	 * f.e. resets the code counter
@@ -79,4 +87,10 @@ public:
 	 * Usage and events depend on implementation (f.e. reset on set)
 	 */
 	virtual void SetEEPROM(AFINStateEEPROM* InEEPROM) {}
+
+	/**
+	 * Gets called by the kernel in the main thread after it executed the queued futures.
+	 * Allows the processor to continue a program that waits for futures to get done.
+	 */
+	virtual void HandleFutures() {}
 };
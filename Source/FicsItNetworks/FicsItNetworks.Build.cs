@@ -29,6 +29,7 @@ public class FicsItNetworks : ModuleRules
             "AnimGraphRuntime",
             "Slate", "SlateCore",
             "Json",
+            "Projects",
             "ApplicationCore",
             "Vorbis",
             "Http",
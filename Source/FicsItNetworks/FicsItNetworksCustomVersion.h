@@ -18,6 +18,9 @@ enum EFINCustomVersion {
 	// FicsIt-Kernel Refactor
 	FINKernelRefactor,
 
+	// Raw, content hashed and deduplicated file system serialization
+	FINContentHashedFileSystem,
+
     // -----<new versions can be added above this line>-------------------------------------------------
     FINVersionPlusOne,
     FINLatestVersion = FINVersionPlusOne - 1
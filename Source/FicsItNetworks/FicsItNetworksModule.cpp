@@ -10,7 +10,9 @@
 #include "Computer/FINComputerDriveDesc.h"
 #include "Computer/FINComputerRCO.h"
 #include "Computer/FINComputerSubsystem.h"
+#include "FicsItKernel/KernelTimerWheel.h"
 #include "FicsItKernel/FicsItFS/Library/Tests.h"
+#include "Reflection/FINReflectionTests.h"
 #include "Hologram/FGBuildableHologram.h"
 #include "Network/FINNetworkConnectionComponent.h"
 #include "Network/FINNetworkAdapter.h"
@@ -24,12 +26,18 @@
 #include "UI/FINCopyUUIDButton.h"
 #include "UI/FINReflectionStyles.h"
 #include "UObject/CoreRedirects.h"
+#include "Containers/Ticker.h"
 
 DEFINE_LOG_CATEGORY( LogGame );
 DEFINE_LOG_CATEGORY(LogFicsItNetworks);
 IMPLEMENT_GAME_MODULE(FFicsItNetworksModule, FicsItNetworks);
 
 FDateTime FFicsItNetworksModule::GameStart;
+uint64 FFicsItNetworksModule::GameStartCycles = 0;
+
+int64 FFicsItNetworksModule::GetGameMillis() {
+	return FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - GameStartCycles);
+}
 
 //#pragma optimize("", o
 
@@ -112,8 +120,15 @@ void AddRedirects(FString FromParent, FString ToParent, const ClassChange& Chang
 
 void FFicsItNetworksModule::StartupModule(){
 	CodersFileSystem::Tests::TestPath();
+	CodersFileSystem::Tests::TestMemFile();
+	FINReflectionTests::TestMetaCache();
 	
 	GameStart = FDateTime::Now();
+	GameStartCycles = FPlatformTime::Cycles64();
+	TimerWheelTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([](float) {
+		FFINKernelTimerWheel::Get().Advance(GetGameMillis());
+		return true;
+	}));
 	
 	TArray<FCoreRedirect> redirects;
 	redirects.Add(FCoreRedirect{ECoreRedirectFlags::Type_Class, TEXT("/Script/FicsItNetworks.FINNetworkConnector"), TEXT("/Script/FicsItNetworks.FINAdvancedNetworkConnectionComponent")});
@@ -251,6 +266,7 @@ void FFicsItNetworksModule::StartupModule(){
 }
 
 void FFicsItNetworksModule::ShutdownModule() {
+	FTicker::GetCoreTicker().RemoveTicker(TimerWheelTickerHandle);
 	FFINReflectionStyles::Shutdown();
 }
 
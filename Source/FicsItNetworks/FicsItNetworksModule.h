@@ -8,6 +8,13 @@ class FFicsItNetworksModule : public FDefaultGameModuleImpl
 {
 public:
 	static FDateTime GameStart;
+	static uint64 GameStartCycles;
+
+	/**
+	 * Returns the milliseconds passed since the module got loaded.
+	 * Based on the monotonic cpu cycle counter, so it is cheap to call and doesn't jump with the wall clock.
+	 */
+	static int64 GetGameMillis();
 	
 	/**
 	* Called when the module is loaded into memory
@@ -20,4 +27,7 @@ public:
 	virtual void ShutdownModule() override;
 
 	virtual bool IsGameModule() const override { return true; }
+
+private:
+	FDelegateHandle TimerWheelTickerHandle;
 };
\ No newline at end of file
@@ -62,6 +62,7 @@ struct FICSITNETWORKS_API FFINFutureReflection : public FFINFuture {
 			bDone = true;
 		} else if (Property) {
 			Property->SetValue(Context, Input[0]);
+			bDone = true;
 		} else {
 			UE_LOG(LogFicsItNetworks, Error, TEXT("Future unable to get executed due to invalid function/property pointer!"));
 		}
@@ -72,6 +73,65 @@ struct FICSITNETWORKS_API FFINFutureReflection : public FFINFuture {
 	}
 };
 
+/**
+ * A single property assignment of a FFINFuturePropertyBatch
+ */
+USTRUCT()
+struct FICSITNETWORKS_API FFINFuturePropertyBatchEntry {
+	GENERATED_BODY()
+
+	UPROPERTY(SaveGame)
+	FFINExecutionContext Context;
+
+	UPROPERTY(SaveGame)
+	UFINProperty* Property = nullptr;
+
+	UPROPERTY(SaveGame)
+	FFINAnyNetworkValue Value;
+};
+
+/**
+ * Sets many properties at once in the main thread.
+ * A failing assignment doesn't stop the others, its error message gets collected instead.
+ * The output is the array of the collected error messages.
+ */
+USTRUCT()
+struct FICSITNETWORKS_API FFINFuturePropertyBatch : public FFINFuture {
+	GENERATED_BODY()
+
+	UPROPERTY(SaveGame)
+	bool bDone = false;
+
+	UPROPERTY(SaveGame)
+	TArray<FFINFuturePropertyBatchEntry> Entries;
+
+	UPROPERTY(SaveGame)
+	TArray<FFINAnyNetworkValue> Errors;
+
+	virtual bool IsDone() const override { return bDone; }
+
+	virtual void Execute() override {
+		for (const FFINFuturePropertyBatchEntry& Entry : Entries) {
+			if (!Entry.Property) continue;
+			try {
+				Entry.Property->SetValue(Entry.Context, Entry.Value);
+			} catch (const FFINException& Ex) {
+				AddError(Entry.Property, Ex.GetMessage());
+			}
+		}
+		Entries.Empty();
+		bDone = true;
+	}
+
+	virtual TArray<FFINAnyNetworkValue> GetOutput() const override {
+		return {FFINAnyNetworkValue(Errors)};
+	}
+
+	void AddError(UFINProperty* Property, const FString& Message) {
+		Errors.Add(FString::Printf(TEXT("%s: %s"), *Property->GetInternalName(), *Message));
+	}
+};
+
 USTRUCT()
 struct FICSITNETWORKS_API FFINFunctionFuture : public FFINFuture {
 	GENERATED_BODY()
@@ -131,6 +131,14 @@ FFINNetworkTrace::FFINNetworkTrace(const FFINNetworkTrace& trace) {
 	Obj = trace.Obj;
 }
 
+FFINNetworkTrace::FFINNetworkTrace(FFINNetworkTrace&& trace) {
+	traceRegisterSteps();
+
+	Prev = MoveTemp(trace.Prev);
+	Step = MoveTemp(trace.Step);
+	Obj = trace.Obj;
+}
+
 FFINNetworkTrace& FFINNetworkTrace::operator=(const FFINNetworkTrace& trace) {
 	Prev = MakeShareable((trace.Prev) ? new FFINNetworkTrace(*trace.Prev) : nullptr);
 	Step = trace.Step;
@@ -199,6 +207,35 @@ FFINNetworkTrace FFINNetworkTrace::operator/(UObject* other) const {
 	return trace;
 }
 
+TArray<FFINNetworkTrace> FFINNetworkTrace::AppendAll(const TArray<UObject*>& others) const {
+	TArray<FFINNetworkTrace> traces;
+	traces.Reserve(others.Num());
+	
+	UObject* A = Obj;
+	if (!::IsValid(A)) {
+		for (int i = 0; i < others.Num(); ++i) traces.Emplace(nullptr);
+		return traces;
+	}
+
+	TSharedPtr<FFINNetworkTrace> sharedPrev = MakeShared<FFINNetworkTrace>(*this);
+	UClass* lastClass = nullptr;
+	TSharedPtr<FFINTraceStep, ESPMode::ThreadSafe> lastStep;
+	for (UObject* other : others) {
+		if (!other) {
+			traces.Emplace(nullptr);
+			continue;
+		}
+		FFINNetworkTrace& trace = traces.Emplace_GetRef(other);
+		trace.Prev = sharedPrev;
+		if (other->GetClass() != lastClass) {
+			lastClass = other->GetClass();
+			lastStep = findTraceStep(A->GetClass(), lastClass);
+		}
+		trace.Step = lastStep;
+	}
+	return traces;
+}
+
 UObject* FFINNetworkTrace::operator*() const {
 	UObject* B = Obj;
 	if (IsValid() && ::IsValid(B)) {
@@ -268,6 +305,26 @@ bool FFINNetworkTrace::IsEqualObj(const FFINNetworkTrace& other) const {
 	return Obj == other.Obj;
 }
 
+bool FFINNetworkTrace::IsEqualTrace(const FFINNetworkTrace& other) const {
+	const FFINNetworkTrace* A = this;
+	const FFINNetworkTrace* B = &other;
+	while (A && B) {
+		if (A == B) return true;
+		if (A->Obj != B->Obj || A->Step != B->Step) return false;
+		A = A->Prev.Get();
+		B = B->Prev.Get();
+	}
+	return A == B;
+}
+
+uint32 FFINNetworkTrace::GetTraceHash() const {
+	uint32 hash = 0;
+	for (const FFINNetworkTrace* trace = this; trace; trace = trace->Prev.Get()) {
+		hash = HashCombine(hash, HashCombine(::GetTypeHash(trace->Obj), ::GetTypeHash(trace->Step.Get())));
+	}
+	return hash;
+}
+
 bool FFINNetworkTrace::operator<(const FFINNetworkTrace& other) const {
 	struct TWOP {
 		int32		ObjectIndex;
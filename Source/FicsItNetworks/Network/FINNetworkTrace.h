@@ -41,6 +41,7 @@ public:
 	static TSharedPtr<FFINTraceStep, ESPMode::ThreadSafe> findTraceStep(UClass* A, UClass* B);
 	
 	FFINNetworkTrace(const FFINNetworkTrace& trace);
+	FFINNetworkTrace(FFINNetworkTrace&& trace);
 	FFINNetworkTrace& operator=(const FFINNetworkTrace& trace);
 
 	explicit FFINNetworkTrace();
@@ -59,6 +60,14 @@ public:
 	 */
 	FFINNetworkTrace operator/(UObject* other) const;
 
+	/**
+	 * Works like operator/ for each of the given objects,
+	 * but all resulting traces share one copy of this trace as previous trace
+	 * and the trace step gets only looked up once per class of the given objects.
+	 * @return the expanded network traces in the order of the given objects
+	 */
+	TArray<FFINNetworkTrace> AppendAll(const TArray<UObject*>& others) const;
+
 	/**
 	 * Returns the referenced object.
 	 * nullptr if trace is invalid
@@ -111,6 +120,16 @@ public:
 	 */
 	bool IsEqualObj(const FFINNetworkTrace& Other) const;
 
+	/**
+	 * Checks if both traces reference the same objects with the same trace steps along the whole trace
+	 */
+	bool IsEqualTrace(const FFINNetworkTrace& Other) const;
+
+	/**
+	 * Returns a hash of the objects and trace steps along the whole trace,
+	 * equal traces by IsEqualTrace have the same hash
+	 */
+	uint32 GetTraceHash() const;
 
 	/**
 	 * Checks if the given trace is larger than self by the underlying objects
@@ -0,0 +1,59 @@
+#include "FINSignalFilter.h"
+
+#include "FINSignalData.h"
+#include "FGInventoryComponent.h"
+#include "ItemAmount.h"
+#include "FicsItNetworks/Reflection/FINSignal.h"
+
+bool FFINSignalArgFilter::Matches(const FFINAnyNetworkValue& Arg) const {
+	switch (Type) {
+	case FIN_SIGNAL_ARG_EQUALS:
+		switch (Value.GetType()) {
+		case FIN_NIL:
+			return Arg.GetType() == FIN_NIL;
+		case FIN_BOOL:
+			return Arg.GetType() == FIN_BOOL && Arg.GetBool() == Value.GetBool();
+		case FIN_INT:
+			if (Arg.GetType() == FIN_INT) return Arg.GetInt() == Value.GetInt();
+			return Arg.GetType() == FIN_FLOAT && Arg.GetFloat() == Value.GetFloat();
+		case FIN_FLOAT:
+			return (Arg.GetType() == FIN_INT || Arg.GetType() == FIN_FLOAT) && Arg.GetFloat() == Value.GetFloat();
+		case FIN_STR:
+			return Arg.GetType() == FIN_STR && Arg.GetString() == Value.GetString();
+		case FIN_CLASS:
+			return Arg.GetType() == FIN_CLASS && Arg.GetClass() == Value.GetClass();
+		case FIN_OBJ:
+		case FIN_TRACE:
+			return (Arg.GetType() == FIN_OBJ || Arg.GetType() == FIN_TRACE) && Arg.GetObj() == Value.GetObj();
+		case FIN_STRUCT:
+			return Arg.GetType() == FIN_STRUCT && Arg.GetStruct().GetStruct() == Value.GetStruct().GetStruct()
+				&& Value.GetStruct().GetStruct()->CompareScriptStruct(Arg.GetStruct().GetData(), Value.GetStruct().GetData(), PPF_None);
+		default:
+			return false;
+		}
+	case FIN_SIGNAL_ARG_RANGE: {
+		if (Arg.GetType() != FIN_INT && Arg.GetType() != FIN_FLOAT) return false;
+		const double Number = Arg.GetFloat();
+		return Number >= Min && Number <= Max;
+	} case FIN_SIGNAL_ARG_ITEM: {
+		UClass* Item = nullptr;
+		if (Arg.GetType() == FIN_CLASS) {
+			Item = Arg.GetClass();
+		} else if (Arg.GetType() == FIN_STRUCT) {
+			const FINStruct& Struct = Arg.GetStruct();
+			if (Struct.GetStruct() == TBaseStructure<FInventoryItem>::Get()) Item = Struct.Get<FInventoryItem>().ItemClass;
+			else if (Struct.GetStruct() == TBaseStructure<FItemAmount>::Get()) Item = Struct.Get<FItemAmount>().ItemClass;
+		}
+		return Item && ItemType && Item->IsChildOf(ItemType);
+	} default:
+		return false;
+	}
+}
+
+bool FFINSignalFilter::Matches(const FFINSignalData& Signal) const {
+	if (Signals.Num() > 0 && (!Signal.Signal || !Signals.Contains(Signal.Signal->GetInternalName()))) return false;
+	for (const FFINSignalArgFilter& Arg : Args) {
+		if (!Signal.Data.IsValidIndex(Arg.Index) || !Arg.Matches(Signal.Data[Arg.Index])) return false;
+	}
+	return true;
+}
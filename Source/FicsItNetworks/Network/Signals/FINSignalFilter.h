@@ -0,0 +1,81 @@
+#pragma once
+
+#include "FicsItNetworks/Network/FINAnyNetworkValue.h"
+#include "FINSignalFilter.generated.h"
+
+struct FFINSignalData;
+
+UENUM()
+enum EFINSignalArgFilterType {
+	FIN_SIGNAL_ARG_EQUALS,
+	FIN_SIGNAL_ARG_RANGE,
+	FIN_SIGNAL_ARG_ITEM,
+};
+
+/**
+ * A predicate on a single parameter of a signal
+ */
+USTRUCT()
+struct FICSITNETWORKS_API FFINSignalArgFilter {
+	GENERATED_BODY()
+
+	/**
+	 * The index of the signal parameter this predicate checks
+	 */
+	UPROPERTY(SaveGame)
+	int32 Index = 0;
+
+	UPROPERTY(SaveGame)
+	TEnumAsByte<EFINSignalArgFilterType> Type = FIN_SIGNAL_ARG_EQUALS;
+
+	/**
+	 * The value the parameter has to be equal to
+	 */
+	UPROPERTY(SaveGame)
+	FFINAnyNetworkValue Value;
+
+	/**
+	 * The inclusive range the numeric parameter has to be in
+	 */
+	UPROPERTY(SaveGame)
+	double Min = TNumericLimits<double>::Lowest();
+	UPROPERTY(SaveGame)
+	double Max = TNumericLimits<double>::Max();
+
+	/**
+	 * The item type the item, item amount or class parameter has to be of
+	 */
+	UPROPERTY(SaveGame)
+	UClass* ItemType = nullptr;
+
+	/**
+	 * Checks if the given signal parameter fulfills this predicate
+	 */
+	bool Matches(const FFINAnyNetworkValue& Arg) const;
+};
+
+/**
+ * A filter the signal subsystem applies to the signals of a sender
+ * before it passes them to the listener, so only signals the listener wants get queued.
+ */
+USTRUCT()
+struct FICSITNETWORKS_API FFINSignalFilter {
+	GENERATED_BODY()
+
+	/**
+	 * Internal names of the signals that pass the filter, all signals pass if empty
+	 */
+	UPROPERTY(SaveGame)
+	TArray<FString> Signals;
+
+	/**
+	 * Predicates all the parameters of a signal have to fulfill
+	 */
+	UPROPERTY(SaveGame)
+	TArray<FFINSignalArgFilter> Args;
+
+	/**
+	 * Checks if the given signal passes the filter
+	 */
+	bool Matches(const FFINSignalData& Signal) const;
+};
@@ -12,15 +12,37 @@ void FFINSignalListeners::AddStructReferencedObjects(FReferenceCollector& Refere
 	}
 }
 
+void AFINSignalSubsystem::BeginPlay() {
+	Super::BeginPlay();
+	GUObjectArray.AddUObjectDeleteListener(this);
+}
+
+void AFINSignalSubsystem::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	Super::EndPlay(EndPlayReason);
+	GUObjectArray.RemoveUObjectDeleteListener(this);
+}
+
 bool AFINSignalSubsystem::ShouldSave_Implementation() const {
 	return true;
 }
 
 void AFINSignalSubsystem::PreSaveGame_Implementation(int32 saveVersion, int32 gameVersion) {
+	// don't save listeners of objects pending kill
 	Cleanup();
 }
 
 void AFINSignalSubsystem::PostLoadGame_Implementation(int32 saveVersion, int32 gameVersion) {
+	FScopeLock Lock(&ListenersMutex);
+	Cleanup();
+	
+	// rebuild reverse index
+	ReceiverSenders.Empty();
+	for (const TPair<UObject*, FFINSignalListeners>& Sender : Listeners) {
+		for (const FFINNetworkTrace& Listener : Sender.Value.Listeners) {
+			ReceiverSenders.FindOrAdd(Listener.GetUnderlyingPtr()).Add(Sender.Key);
+		}
+	}
+	
 	AFINHookSubsystem* HookSubsystem = AFINHookSubsystem::GetHookSubsystem(this);
 	if (HookSubsystem) for (const TPair<UObject*, FFINSignalListeners>& Sender : Listeners) {
 		HookSubsystem->AttachHooks(Sender.Key);
@@ -33,23 +55,68 @@ void AFINSignalSubsystem::GatherDependencies_Implementation(TArray<UObject*>& ou
 	out_dependentObjects.Add(AFINHookSubsystem::GetHookSubsystem(this));
 }
 
+void AFINSignalSubsystem::NotifyUObjectDeleted(const UObjectBase* Object, int32 Index) {
+	FScopeLock Lock(&ListenersMutex);
+	RemoveObject(Object);
+}
+
+void AFINSignalSubsystem::OnUObjectArrayShutdown() {
+	GUObjectArray.RemoveUObjectDeleteListener(this);
+}
+
+bool AFINSignalSubsystem::RemoveListener(UObject* Sender, UObject* Receiver) {
+	FFINSignalListeners* ListenerList = Listeners.Find(Sender);
+	if (!ListenerList) return false;
+	ListenerList->Filters.Remove(Receiver);
+	ListenerList->Listeners.RemoveAllSwap([Receiver](const FFINNetworkTrace& Listener) {
+		// the gc might have already cleared the pointer of a destroyed receiver
+		UObject* Ptr = Listener.GetUnderlyingPtr();
+		return Ptr == Receiver || !Ptr;
+	});
+	if (ListenerList->Listeners.Num() > 0) return false;
+	Listeners.Remove(Sender);
+	return true;
+}
+
+void AFINSignalSubsystem::RemoveObject(const UObjectBase* Object) {
+	UObject* Obj = static_cast<UObject*>(const_cast<UObjectBase*>(Object));
+
+	// object as sender
+	FFINSignalListeners SenderListeners;
+	if (Listeners.RemoveAndCopyValue(Obj, SenderListeners)) {
+		for (const FFINNetworkTrace& Listener : SenderListeners.Listeners) {
+			TSet<UObject*>* Senders = ReceiverSenders.Find(Listener.GetUnderlyingPtr());
+			if (!Senders) continue;
+			Senders->Remove(Obj);
+			if (Senders->Num() < 1) ReceiverSenders.Remove(Listener.GetUnderlyingPtr());
+		}
+	}
+
+	// object as receiver
+	TSet<UObject*> Senders;
+	if (ReceiverSenders.RemoveAndCopyValue(Obj, Senders)) {
+		for (UObject* Sender : Senders) RemoveListener(Sender, Obj);
+	}
+}
+
 void AFINSignalSubsystem::Cleanup() {
+	FScopeLock Lock(&ListenersMutex);
 	TArray<UObject*> ListenerKeys;
 	Listeners.GetKeys(ListenerKeys);
 	for (UObject* Sender : ListenerKeys) {
 		if (!IsValid(Sender)) {
-			Listeners.Remove(Sender);
-		} else {
-			TArray<FFINNetworkTrace>& Listen = Listeners[Sender].Listeners;
-			for (int i = 0; i < Listen.Num(); ++i) {
-				const FFINNetworkTrace& Listener = Listen[i];
-				if (!IsValid(Listener.GetUnderlyingPtr())) {
-					Listen.RemoveAt(i--);
-				}
-			}
-			if (Listen.Num() < 1) {
-				Listeners.Remove(Sender);
-			}
+			RemoveObject(Sender);
+			continue;
+		}
+		FFINSignalListeners* ListenerList = Listeners.Find(Sender);
+		if (!ListenerList) continue;
+		TArray<UObject*> InvalidReceivers;
+		for (const FFINNetworkTrace& Listener : ListenerList->Listeners) {
+			if (!IsValid(Listener.GetUnderlyingPtr())) InvalidReceivers.Add(Listener.GetUnderlyingPtr());
+		}
+		for (UObject* Receiver : InvalidReceivers) {
+			RemoveObject(Receiver);
+			RemoveListener(Sender, Receiver);
 		}
 	}
 }
@@ -60,8 +127,8 @@ AFINSignalSubsystem* AFINSignalSubsystem::GetSignalSubsystem(UObject* WorldConte
 	check(SubsystemActorManager);
 	return SubsystemActorManager->GetSubsystemActor<AFINSignalSubsystem>();
 }
-
 void AFINSignalSubsystem::BroadcastSignal(UObject* Sender, const FFINSignalData& Signal) {
+	FScopeLock Lock(&ListenersMutex);
 	FFINSignalListeners* ListenerList = Listeners.Find(Sender);
 	if (!ListenerList) return;
 	for (const FFINNetworkTrace& ReceiverTrace : ListenerList->Listeners) {
@@ -69,6 +136,10 @@ void AFINSignalSubsystem::BroadcastSignal(UObject* Sender, const FFINSignalData&
 			UE_LOG(LogFicsItNetworks, Warning, TEXT("SignalSubsystem: Invalid receiver trave. Sender: %s, ListenerList: %p, Listeners.Num(): %i"), *Sender->GetName(), ListenerList, ListenerList->Listeners.Num());
 			continue;
 		}
+		if (ListenerList->Filters.Num() > 0) {
+			const FFINSignalFilter* Filter = ListenerList->Filters.Find(ReceiverTrace.GetUnderlyingPtr());
+			if (Filter && !Filter->Matches(Signal)) continue;
+		}
 		IFINSignalListener* Receiver = Cast<IFINSignalListener>(ReceiverTrace.Get());
 		if (Receiver) {
 			Receiver->HandleSignal(Signal, ReceiverTrace.Reverse());
@@ -77,39 +148,46 @@ void AFINSignalSubsystem::BroadcastSignal(UObject* Sender, const FFINSignalData&
 }
 
 void AFINSignalSubsystem::Listen(UObject* Sender, const FFINNetworkTrace& Receiver) {
-	TArray<FFINNetworkTrace>& ListenerList = Listeners.FindOrAdd(Sender).Listeners;
-	ListenerList.AddUnique(Receiver);
+	FScopeLock Lock(&ListenersMutex);
+	FFINSignalListeners& ListenerList = Listeners.FindOrAdd(Sender);
+	ListenerList.Listeners.AddUnique(Receiver);
+	ListenerList.Filters.Remove(Receiver.GetUnderlyingPtr());
+	ReceiverSenders.FindOrAdd(Receiver.GetUnderlyingPtr()).Add(Sender);
 	AFINHookSubsystem::GetHookSubsystem(Sender)->AttachHooks(Sender);
 }
 
+void AFINSignalSubsystem::ListenFiltered(UObject* Sender, const FFINNetworkTrace& Receiver, const FFINSignalFilter& Filter) {
+	FScopeLock Lock(&ListenersMutex);
+	Listen(Sender, Receiver);
+	Listeners[Sender].Filters.Add(Receiver.GetUnderlyingPtr(), Filter);
+}
+
 void AFINSignalSubsystem::Ignore(UObject* Sender, UObject* Receiver) {
-	FFINSignalListeners* ListenerList = Listeners.Find(Sender);
-	if (!ListenerList) return;
-	for (int i = 0; i < ListenerList->Listeners.Num(); ++i) {
-		if (ListenerList->Listeners[i].GetUnderlyingPtr() == Receiver) {
-			ListenerList->Listeners.RemoveAt(i);
-			--i;
-		}
-	}
-	if (!Sender) return;
+	FScopeLock Lock(&ListenersMutex);
+	TSet<UObject*>* Senders = ReceiverSenders.Find(Receiver);
+	if (!Senders || !Senders->Contains(Sender)) return;
+	Senders->Remove(Sender);
+	if (Senders->Num() < 1) ReceiverSenders.Remove(Receiver);
+	if (!RemoveListener(Sender, Receiver) || !Sender) return;
 	AFINHookSubsystem* HookSubsystem = AFINHookSubsystem::GetHookSubsystem(Sender);
-	if (ListenerList->Listeners.Num() < 1 && HookSubsystem) HookSubsystem->ClearHooks(Sender);
+	if (HookSubsystem) HookSubsystem->ClearHooks(Sender);
 }
 
 void AFINSignalSubsystem::IgnoreAll(UObject* Receiver) {
-	TArray<UObject*> Senders;
-	Listeners.GetKeys(Senders);
+	FScopeLock Lock(&ListenersMutex);
+	TSet<UObject*> Senders;
+	if (!ReceiverSenders.RemoveAndCopyValue(Receiver, Senders)) return;
+	AFINHookSubsystem* HookSubsystem = nullptr;
 	for (UObject* Sender : Senders) {
-		Ignore(Sender, Receiver);
+		if (!RemoveListener(Sender, Receiver) || !Sender) continue;
+		if (!HookSubsystem) HookSubsystem = AFINHookSubsystem::GetHookSubsystem(Sender);
+		if (HookSubsystem) HookSubsystem->ClearHooks(Sender);
 	}
 }
 
 TArray<UObject*> AFINSignalSubsystem::GetListening(UObject* Reciever) {
-	TArray<UObject*> Listening;
-	for (TPair<UObject*, FFINSignalListeners> Sender : Listeners) {
-		if (Sender.Value.Listeners.Contains(FFINNetworkTrace(Reciever))) {
-			Listening.Add(Sender.Key);
-		}
-	}
-	return Listening;
+	FScopeLock Lock(&ListenersMutex);
+	const TSet<UObject*>* Senders = ReceiverSenders.Find(Reciever);
+	if (!Senders) return {};
+	return Senders->Array();
 }
@@ -3,6 +3,7 @@
 #include "Subsystem/ModSubsystem.h"
 #include "FGSaveInterface.h"
 #include "FINSignalData.h"
+#include "FINSignalFilter.h"
 #include "FINSignalSubsystem.generated.h"
 
 USTRUCT()
@@ -12,6 +13,12 @@ struct FICSITNETWORKS_API FFINSignalListeners {
 	UPROPERTY(SaveGame)
 	TArray<FFINNetworkTrace> Listeners;
 
+	/**
+	 * Filters of the listeners that don't want to receive all signals, mapped by receiver object
+	 */
+	UPROPERTY(SaveGame)
+	TMap<UObject*, FFINSignalFilter> Filters;
+
 	void AddStructReferencedObjects(FReferenceCollector& ReferenceCollector) const;
 };
 
@@ -23,7 +30,7 @@ struct TStructOpsTypeTraits<FFINSignalListeners> : TStructOpsTypeTraitsBase2<FFI
 };
 
 UCLASS(BlueprintType)
-class FICSITNETWORKS_API AFINSignalSubsystem : public AModSubsystem, public IFGSaveInterface {
+class FICSITNETWORKS_API AFINSignalSubsystem : public AModSubsystem, public IFGSaveInterface, public FUObjectArray::FUObjectDeleteListener {
 	GENERATED_BODY()
 private:
 	/**
@@ -31,8 +38,38 @@ private:
 	 */
 	UPROPERTY(SaveGame)
 	TMap<UObject*, FFINSignalListeners> Listeners;
+
+	/**
+	 * Reverse index of Listeners, maps receiver objects to the senders they listen to
+	 */
+	TMap<UObject*, TSet<UObject*>> ReceiverSenders;
+
+	/**
+	 * Guards Listeners and ReceiverSenders, as deleted objects might get reported by the async purge of the GC
+	 */
+	FCriticalSection ListenersMutex;
+
+	/**
+	 * Removes the given receiver from the listener list of the given sender
+	 * and removes the sender entry if no listener is left.
+	 * Expects the listeners lock to be held.
+	 *
+	 * @return	true if the sender has no listeners anymore
+	 */
+	bool RemoveListener(UObject* Sender, UObject* Receiver);
+
+	/**
+	 * Removes the given object as sender and as receiver of signals.
+	 * Expects the listeners lock to be held.
+	 */
+	void RemoveObject(const UObjectBase* Object);
 	
 public:
+	// Begin AActor
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	// End AActor
+
 	// Begin IFGSaveInterface
 	virtual bool ShouldSave_Implementation() const override;
 	virtual void PreSaveGame_Implementation(int32 saveVersion, int32 gameVersion) override;
@@ -40,14 +77,21 @@ public:
 	virtual void GatherDependencies_Implementation(TArray<UObject*>& out_dependentObjects) override;
 	// End IFGSaveInterface
 
+	// Begin FUObjectDeleteListener
+	virtual void NotifyUObjectDeleted(const UObjectBase* Object, int32 Index) override;
+	virtual void OnUObjectArrayShutdown() override;
+	// End FUObjectDeleteListener
+
 	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& ReferenceCollector) {
 		Super::AddReferencedObjects(InThis, ReferenceCollector);
 		AFINSignalSubsystem* SigSubSys = Cast<AFINSignalSubsystem>(InThis);
+		FScopeLock Lock(&SigSubSys->ListenersMutex);
 		for (TPair<UObject*, FFINSignalListeners>& Listener : SigSubSys->Listeners) Listener.Value.AddStructReferencedObjects(ReferenceCollector);
 	}
 
 	/**
-	 * Removes all Listeners and sender that don't exist anymore
+	 * Removes all Listeners and sender that don't exist anymore.
+	 * Deleted objects get removed when they get destroyed, so this is only needed to drop pending kill objects early.
 	 */
 	void Cleanup();
 
@@ -71,6 +115,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Network|Signals")
 	void Listen(UObject* Sender, const FFINNetworkTrace& Receiver);
 
+	/**
+	 * Adds the given listener to the listener list of the given sender,
+	 * only signals passing the given filter get passed to the listener.
+	 * Replaces the filter if the listener already listens to the sender.
+	 */
+	void ListenFiltered(UObject* Sender, const FFINNetworkTrace& Receiver, const FFINSignalFilter& Filter);
+
 	/**
 	 * Removes the given listener from the listener list of the given sender
 	 */
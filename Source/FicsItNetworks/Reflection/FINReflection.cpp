@@ -8,6 +8,7 @@
 #include "FINFuncProperty.h"
 #include "FINIntProperty.h"
 #include "FINObjectProperty.h"
+#include "FINReflectionMetaCache.h"
 #include "FINStaticReflectionSource.h"
 #include "FINStrProperty.h"
 #include "FINStructProperty.h"
@@ -37,6 +38,14 @@ void FFINReflection::PopulateSources() {
 }
 
 void FFINReflection::LoadAllTypes() {
+	const double Start = FPlatformTime::Seconds();
+
+	// reuse the meta data of the last start if nothing changed since then
+	FFINReflectionMetaCache& MetaCache = FFINReflectionMetaCache::Get();
+	const uint32 MetaCacheKey = FFINReflectionMetaCache::CalculateKey();
+	const bool bMetaCacheLoaded = MetaCache.LoadFromFile(FFINReflectionMetaCache::GetCachePath(), MetaCacheKey);
+	if (!bMetaCacheLoaded) MetaCache.Reset(MetaCacheKey);
+	
 	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
 
 	TArray<FString> PathsToScan;
@@ -53,6 +62,7 @@ void FFINReflection::LoadAllTypes() {
 	Filter.ClassNames.Add(UClass::StaticClass()->GetFName());
 	AssetRegistryModule.Get().GetAssets(Filter, AssetData);
 
+	TArray<UClass*> AssetClasses;
 	for (const FAssetData& Asset : AssetData) {
 		FString Path = Asset.ObjectPath.ToString();
 		if (!Path.EndsWith("_C")) Path += "_C";
@@ -61,6 +71,15 @@ void FFINReflection::LoadAllTypes() {
 			Class = LoadClass<UObject>(NULL, *Path);
 		}
 		if (!Class) continue;
+		AssetClasses.Add(Class);
+	}
+
+	const double LoadedTime = FPlatformTime::Seconds();
+
+	// all classes are loaded now, so the child counts stay valid while populating
+	BuildClassChildCounts();
+	
+	for (UClass* Class : AssetClasses) {
 		FindClass(Class);
 	}
 
@@ -71,6 +90,38 @@ void FFINReflection::LoadAllTypes() {
 	for (TObjectIterator<UScriptStruct> Struct; Struct; ++Struct) {
 		if (!Struct->GetName().StartsWith("SKEL_") && !Struct->GetName().StartsWith("REINST_")) FindStruct(*Struct);
 	}
+
+	ClassChildCounts.Empty();
+
+	if (MetaCache.bDirty) {
+		if (MetaCache.SaveToFile(FFINReflectionMetaCache::GetCachePath())) MetaCache.bDirty = false;
+		else UE_LOG(LogFicsItNetworks, Warning, TEXT("Unable to save reflection meta cache to '%s'"), *FFINReflectionMetaCache::GetCachePath());
+	}
+
+	const double End = FPlatformTime::Seconds();
+	UE_LOG(LogFicsItNetworks, Display, TEXT("Reflection populated with %i classes and %i structs in %.2fms (asset loading %.2fms, population %.2fms, meta cache %s)"), Classes.Num(), Structs.Num(), (End - Start) * 1000.0, (LoadedTime - Start) * 1000.0, (End - LoadedTime) * 1000.0, bMetaCacheLoaded ? TEXT("loaded") : TEXT("rebuilt"));
+}
+
+void FFINReflection::BuildClassChildCounts() {
+	ClassChildCounts.Empty();
+	for (TObjectIterator<UClass> It; It; ++It) {
+		for (UClass* Class = *It; Class; Class = Class->GetSuperClass()) {
+			++ClassChildCounts.FindOrAdd(Class);
+		}
+	}
+}
+
+int32 FFINReflection::GetClassChildCount(UClass* Class) const {
+	const int32* CachedCount = ClassChildCounts.Find(Class);
+	if (CachedCount) return *CachedCount;
+	
+	int32 Count = 0;
+	for (TObjectIterator<UClass> It; It; ++It) {
+		if (It->IsChildOf(Class)) {
+			++Count;
+		}
+	}
+	return Count;
 }
 
 UFINClass* FFINReflection::FindClass(UClass* Clazz, bool bRecursive, bool bTryToReflect) {
@@ -22,6 +22,14 @@ private:
 	TMap<UClass*, UFINClass*> Classes;
 	TMap<UScriptStruct*, UFINStruct*> Structs;
 	TArray<const UFINReflectionSource*> Sources;
+
+	/**
+	 * Count of loaded classes being a child of the key class (including the class itself),
+	 * only available while LoadAllTypes populates the reflection
+	 */
+	TMap<UClass*, int32> ClassChildCounts;
+
+	void BuildClassChildCounts();
 	
 public:
 	static FFINReflection* Get();
@@ -31,6 +39,11 @@ public:
 	UFINClass* FindClass(UClass* Clazz, bool bRecursive = true, bool bTryToReflect = true);
 	UFINStruct* FindStruct(UScriptStruct* Struct, bool bRecursive = true, bool bTryToReflect = true);
 	void PrintReflection();
+
+	/**
+	 * Returns the count of loaded classes being a child of the given class (including the class itself)
+	 */
+	int32 GetClassChildCount(UClass* Class) const;
 	inline const TMap<UClass*, UFINClass*>& GetClasses() { return Classes; }
 	inline const TMap<UScriptStruct*, UFINStruct*>& GetStructs() { return Structs; }
 };
@@ -0,0 +1,193 @@
+#include "FINReflectionMetaCache.h"
+
+#include "Interfaces/IPluginManager.h"
+#include "Internationalization/Culture.h"
+#include "Internationalization/Internationalization.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#define FIN_REFLECTION_CACHE_MAGIC 0x52434946 // "FICR"
+
+namespace {
+	bool IsEqualText(const FText& A, const FText& B) {
+		return A.ToString() == B.ToString();
+	}
+
+	bool IsEqualTexts(const TArray<FText>& A, const TArray<FText>& B) {
+		if (A.Num() != B.Num()) return false;
+		for (int i = 0; i < A.Num(); ++i) {
+			if (!IsEqualText(A[i], B[i])) return false;
+		}
+		return true;
+	}
+
+	template<typename ValueType, typename EqualFunc>
+	bool IsEqualMap(const TMap<FString, ValueType>& A, const TMap<FString, ValueType>& B, EqualFunc Equal) {
+		if (A.Num() != B.Num()) return false;
+		for (const TPair<FString, ValueType>& Entry : A) {
+			const ValueType* Other = B.Find(Entry.Key);
+			if (!Other || !Equal(Entry.Value, *Other)) return false;
+		}
+		return true;
+	}
+
+	bool IsEqualTextMap(const TMap<FString, FText>& A, const TMap<FString, FText>& B) {
+		return IsEqualMap(A, B, &IsEqualText);
+	}
+}
+
+bool FFINReflectionTypeMeta::IsEqual(const FFINReflectionTypeMeta& Other) const {
+	return InternalName == Other.InternalName
+		&& IsEqualText(DisplayName, Other.DisplayName)
+		&& IsEqualText(Description, Other.Description)
+		&& PropertyInternalNames.OrderIndependentCompareEqual(Other.PropertyInternalNames)
+		&& IsEqualTextMap(PropertyDisplayNames, Other.PropertyDisplayNames)
+		&& IsEqualTextMap(PropertyDescriptions, Other.PropertyDescriptions)
+		&& PropertyRuntimes.OrderIndependentCompareEqual(Other.PropertyRuntimes);
+}
+
+FArchive& operator<<(FArchive& Ar, FFINReflectionTypeMeta& Meta) {
+	Ar << Meta.InternalName;
+	Ar << Meta.DisplayName;
+	Ar << Meta.Description;
+	Ar << Meta.PropertyInternalNames;
+	Ar << Meta.PropertyDisplayNames;
+	Ar << Meta.PropertyDescriptions;
+	Ar << Meta.PropertyRuntimes;
+	return Ar;
+}
+
+bool FFINReflectionFunctionMeta::IsEqual(const FFINReflectionFunctionMeta& Other) const {
+	return InternalName == Other.InternalName
+		&& IsEqualText(DisplayName, Other.DisplayName)
+		&& IsEqualText(Description, Other.Description)
+		&& ParameterInternalNames == Other.ParameterInternalNames
+		&& IsEqualTexts(ParameterDescriptions, Other.ParameterDescriptions)
+		&& IsEqualTexts(ParameterDisplayNames, Other.ParameterDisplayNames)
+		&& Runtime == Other.Runtime;
+}
+
+FArchive& operator<<(FArchive& Ar, FFINReflectionFunctionMeta& Meta) {
+	Ar << Meta.InternalName;
+	Ar << Meta.DisplayName;
+	Ar << Meta.Description;
+	Ar << Meta.ParameterInternalNames;
+	Ar << Meta.ParameterDescriptions;
+	Ar << Meta.ParameterDisplayNames;
+	Ar << Meta.Runtime;
+	return Ar;
+}
+
+bool FFINReflectionSignalMeta::IsEqual(const FFINReflectionSignalMeta& Other) const {
+	return InternalName == Other.InternalName
+		&& IsEqualText(DisplayName, Other.DisplayName)
+		&& IsEqualText(Description, Other.Description)
+		&& ParameterInternalNames == Other.ParameterInternalNames
+		&& IsEqualTexts(ParameterDescriptions, Other.ParameterDescriptions)
+		&& IsEqualTexts(ParameterDisplayNames, Other.ParameterDisplayNames);
+}
+
+FArchive& operator<<(FArchive& Ar, FFINReflectionSignalMeta& Meta) {
+	Ar << Meta.InternalName;
+	Ar << Meta.DisplayName;
+	Ar << Meta.Description;
+	Ar << Meta.ParameterInternalNames;
+	Ar << Meta.ParameterDescriptions;
+	Ar << Meta.ParameterDisplayNames;
+	return Ar;
+}
+
+FFINReflectionMetaCache& FFINReflectionMetaCache::Get() {
+	static FFINReflectionMetaCache Cache;
+	return Cache;
+}
+
+uint32 FFINReflectionMetaCache::CalculateKey() {
+	uint32 Hash = GetTypeHash(FEngineVersion::Current().ToString());
+	Hash = HashCombine(Hash, GetTypeHash(FString(FApp::GetBuildVersion())));
+	Hash = HashCombine(Hash, GetTypeHash(FInternationalization::Get().GetCurrentCulture()->GetName()));
+
+	// the order of the enabled plugins is not stable, so sort them by name first
+	TArray<TSharedRef<IPlugin>> Plugins = IPluginManager::Get().GetEnabledPlugins();
+	Plugins.Sort([](const TSharedRef<IPlugin>& A, const TSharedRef<IPlugin>& B) {
+		return A->GetName() < B->GetName();
+	});
+	for (const TSharedRef<IPlugin>& Plugin : Plugins) {
+		Hash = HashCombine(Hash, GetTypeHash(Plugin->GetName()));
+		Hash = HashCombine(Hash, GetTypeHash(Plugin->GetDescriptor().VersionName));
+	}
+	return Hash;
+}
+
+FString FFINReflectionMetaCache::GetCachePath() {
+	FString Path = FPaths::Combine(FPlatformProcess::UserSettingsDir(), FApp::GetProjectName(), TEXT("Saved/"));
+	return FPaths::Combine(Path, TEXT("FINReflectionCache.bin"));
+}
+
+void FFINReflectionMetaCache::Reset(uint32 InKey) {
+	ClassMetas.Empty();
+	FunctionMetas.Empty();
+	SignalMetas.Empty();
+	Key = InKey;
+	bDirty = false;
+}
+
+void FFINReflectionMetaCache::Save(TArray<uint8>& OutData) const {
+	FMemoryWriter Ar(OutData);
+	int32 Magic = FIN_REFLECTION_CACHE_MAGIC;
+	int32 CacheVersion = Version;
+	uint32 CacheKey = Key;
+	Ar << Magic;
+	Ar << CacheVersion;
+	Ar << CacheKey;
+	Ar << const_cast<TMap<FString, FFINReflectionTypeMeta>&>(ClassMetas);
+	Ar << const_cast<TMap<FString, FFINReflectionFunctionMeta>&>(FunctionMetas);
+	Ar << const_cast<TMap<FString, FFINReflectionSignalMeta>&>(SignalMetas);
+}
+
+bool FFINReflectionMetaCache::Load(const TArray<uint8>& Data, uint32 ExpectedKey) {
+	FMemoryReader Ar(Data);
+	int32 Magic = 0;
+	int32 CacheVersion = 0;
+	uint32 CacheKey = 0;
+	Ar << Magic;
+	Ar << CacheVersion;
+	Ar << CacheKey;
+	if (Ar.IsError() || Magic != FIN_REFLECTION_CACHE_MAGIC || CacheVersion != Version || CacheKey != ExpectedKey) return false;
+
+	TMap<FString, FFINReflectionTypeMeta> NewClassMetas;
+	TMap<FString, FFINReflectionFunctionMeta> NewFunctionMetas;
+	TMap<FString, FFINReflectionSignalMeta> NewSignalMetas;
+	Ar << NewClassMetas;
+	Ar << NewFunctionMetas;
+	Ar << NewSignalMetas;
+	if (Ar.IsError()) return false;
+
+	ClassMetas = MoveTemp(NewClassMetas);
+	FunctionMetas = MoveTemp(NewFunctionMetas);
+	SignalMetas = MoveTemp(NewSignalMetas);
+	Key = CacheKey;
+	bDirty = false;
+	return true;
+}
+
+bool FFINReflectionMetaCache::SaveToFile(const FString& Path) const {
+	TArray<uint8> Data;
+	Save(Data);
+	return FFileHelper::SaveArrayToFile(Data, *Path);
+}
+
+bool FFINReflectionMetaCache::LoadFromFile(const FString& Path, uint32 ExpectedKey) {
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Path, FILEREAD_Silent)) return false;
+	return Load(Data, ExpectedKey);
+}
+
+bool FFINReflectionMetaCache::IsEqual(const FFINReflectionMetaCache& Other) const {
+	return Key == Other.Key
+		&& IsEqualMap(ClassMetas, Other.ClassMetas, [](const FFINReflectionTypeMeta& A, const FFINReflectionTypeMeta& B) { return A.IsEqual(B); })
+		&& IsEqualMap(FunctionMetas, Other.FunctionMetas, [](const FFINReflectionFunctionMeta& A, const FFINReflectionFunctionMeta& B) { return A.IsEqual(B); })
+		&& IsEqualMap(SignalMetas, Other.SignalMetas, [](const FFINReflectionSignalMeta& A, const FFINReflectionSignalMeta& B) { return A.IsEqual(B); });
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Meta data of a class as provided by its netClass_Meta function
+ */
+struct FICSITNETWORKS_API FFINReflectionTypeMeta {
+	FString InternalName;
+	FText DisplayName;
+	FText Description;
+	TMap<FString, FString> PropertyInternalNames;
+	TMap<FString, FText> PropertyDisplayNames;
+	TMap<FString, FText> PropertyDescriptions;
+	TMap<FString, int> PropertyRuntimes;
+
+	bool IsEqual(const FFINReflectionTypeMeta& Other) const;
+	friend FArchive& operator<<(FArchive& Ar, FFINReflectionTypeMeta& Meta);
+};
+
+/**
+ * Meta data of a function as provided by its netFuncMeta_ function
+ */
+struct FICSITNETWORKS_API FFINReflectionFunctionMeta {
+	FString InternalName;
+	FText DisplayName;
+	FText Description;
+	TArray<FString> ParameterInternalNames;
+	TArray<FText> ParameterDescriptions;
+	TArray<FText> ParameterDisplayNames;
+	int Runtime = 1;
+
+	bool IsEqual(const FFINReflectionFunctionMeta& Other) const;
+	friend FArchive& operator<<(FArchive& Ar, FFINReflectionFunctionMeta& Meta);
+};
+
+/**
+ * Meta data of a signal as provided by its netSigMeta_ function
+ */
+struct FICSITNETWORKS_API FFINReflectionSignalMeta {
+	FString InternalName;
+	FText DisplayName;
+	FText Description;
+	TArray<FString> ParameterInternalNames;
+	TArray<FText> ParameterDescriptions;
+	TArray<FText> ParameterDisplayNames;
+
+	bool IsEqual(const FFINReflectionSignalMeta& Other) const;
+	friend FArchive& operator<<(FArchive& Ar, FFINReflectionSignalMeta& Meta);
+};
+
+/**
+ * Caches the meta data the UReflection source gathers by executing the meta functions of classes,
+ * so later starts of the game don't have to run the meta functions again.
+ * The cache gets stored in a versioned binary file and is only valid for the key it got created with,
+ * which is a hash of the engine, game and mod versions and the current culture.
+ */
+class FICSITNETWORKS_API FFINReflectionMetaCache {
+public:
+	/**
+	 * Version of the binary format, increase it if the stored data changes
+	 */
+	static constexpr int32 Version = 1;
+
+	TMap<FString, FFINReflectionTypeMeta> ClassMetas;
+	TMap<FString, FFINReflectionFunctionMeta> FunctionMetas;
+	TMap<FString, FFINReflectionSignalMeta> SignalMetas;
+
+	/**
+	 * The key the cached data is valid for
+	 */
+	uint32 Key = 0;
+
+	/**
+	 * True if entries got added since the cache got loaded
+	 */
+	bool bDirty = false;
+
+	static FFINReflectionMetaCache& Get();
+
+	/**
+	 * Calculates the key of the currently running game, engine and mod versions
+	 */
+	static uint32 CalculateKey();
+
+	/**
+	 * Returns the path to the cache file
+	 */
+	static FString GetCachePath();
+
+	/**
+	 * Removes all entries and sets the key the new entries are valid for
+	 */
+	void Reset(uint32 InKey);
+
+	/**
+	 * Writes the cache with its header into the given buffer
+	 */
+	void Save(TArray<uint8>& OutData) const;
+
+	/**
+	 * Reads the cache from the given buffer.
+	 * Fails and leaves the cache untouched if the buffer has a different version or key.
+	 *
+	 * @param[in]	Data		the buffer created by Save
+	 * @param[in]	ExpectedKey	the key the loaded cache has to be valid for
+	 * @return	true if the cache got loaded
+	 */
+	bool Load(const TArray<uint8>& Data, uint32 ExpectedKey);
+
+	bool SaveToFile(const FString& Path) const;
+	bool LoadFromFile(const FString& Path, uint32 ExpectedKey);
+
+	/**
+	 * Checks if both caches contain the same key and entries
+	 */
+	bool IsEqual(const FFINReflectionMetaCache& Other) const;
+};
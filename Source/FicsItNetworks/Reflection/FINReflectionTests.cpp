@@ -0,0 +1,62 @@
+#include "FINReflectionTests.h"
+
+#include "FINReflectionMetaCache.h"
+
+void FINReflectionTests::TestMetaCache() {
+	FFINReflectionMetaCache Cache;
+	Cache.Reset(1337);
+
+	FFINReflectionTypeMeta& ClassMeta = Cache.ClassMetas.Add(TEXT("/Script/FicsItNetworks.TestClass"));
+	ClassMeta.InternalName = TEXT("TestClass");
+	ClassMeta.DisplayName = FText::FromString(TEXT("Test Class"));
+	ClassMeta.Description = FText::FromString(TEXT("A class for testing"));
+	ClassMeta.PropertyInternalNames.Add(TEXT("prop"), TEXT("property"));
+	ClassMeta.PropertyDisplayNames.Add(TEXT("prop"), FText::FromString(TEXT("Property")));
+	ClassMeta.PropertyDescriptions.Add(TEXT("prop"), FText::FromString(TEXT("A property")));
+	ClassMeta.PropertyRuntimes.Add(TEXT("prop"), 2);
+	Cache.ClassMetas.Add(TEXT("/Script/FicsItNetworks.EmptyClass"));
+
+	FFINReflectionFunctionMeta& FuncMeta = Cache.FunctionMetas.Add(TEXT("/Script/FicsItNetworks.TestClass:netFunc_test"));
+	FuncMeta.InternalName = TEXT("test");
+	FuncMeta.DisplayName = FText::FromString(TEXT("Test"));
+	FuncMeta.Description = FText::FromString(TEXT("A function for testing"));
+	FuncMeta.ParameterInternalNames = {TEXT("a"), TEXT("b")};
+	FuncMeta.ParameterDisplayNames = {FText::FromString(TEXT("A")), FText::FromString(TEXT("B"))};
+	FuncMeta.ParameterDescriptions = {FText::FromString(TEXT("First")), FText::GetEmpty()};
+	FuncMeta.Runtime = 0;
+
+	FFINReflectionSignalMeta& SignalMeta = Cache.SignalMetas.Add(TEXT("/Script/FicsItNetworks.TestClass:netSig_Test"));
+	SignalMeta.InternalName = TEXT("Test");
+	SignalMeta.DisplayName = FText::FromString(TEXT("Test Signal"));
+	SignalMeta.ParameterInternalNames = {TEXT("value")};
+	SignalMeta.ParameterDisplayNames = {FText::FromString(TEXT("Value"))};
+	SignalMeta.ParameterDescriptions = {FText::FromString(TEXT("The value"))};
+
+	TArray<uint8> Data;
+	Cache.Save(Data);
+
+	// round trip
+	FFINReflectionMetaCache Loaded;
+	check(Loaded.Load(Data, 1337));
+	check(Loaded.IsEqual(Cache));
+	check(Cache.IsEqual(Loaded));
+	check(!Loaded.bDirty);
+	check(Loaded.ClassMetas[TEXT("/Script/FicsItNetworks.TestClass")].PropertyRuntimes[TEXT("prop")] == 2);
+	check(Loaded.FunctionMetas[TEXT("/Script/FicsItNetworks.TestClass:netFunc_test")].Runtime == 0);
+
+	// changed entries are detected
+	Loaded.FunctionMetas[TEXT("/Script/FicsItNetworks.TestClass:netFunc_test")].ParameterDescriptions[1] = FText::FromString(TEXT("Second"));
+	check(!Loaded.IsEqual(Cache));
+
+	// other keys, versions or broken data don't get loaded
+	FFINReflectionMetaCache Other;
+	check(!Other.Load(Data, 42));
+	check(Other.ClassMetas.Num() == 0);
+	TArray<uint8> BrokenVersion = Data;
+	BrokenVersion[4] ^= 0xFF;
+	check(!Other.Load(BrokenVersion, 1337));
+	TArray<uint8> Truncated = Data;
+	Truncated.SetNum(Data.Num() / 2);
+	check(!Other.Load(Truncated, 1337));
+	check(Other.ClassMetas.Num() == 0);
+}
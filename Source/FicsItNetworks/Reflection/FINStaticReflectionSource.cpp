@@ -849,6 +849,53 @@ BeginFuncVA(getStack, "Get Stack", "Returns the item stack at the given index.\n
 		}
 	}
 } EndFunc()
+BeginFuncVA(getSnapshot, "Get Snapshot", "Returns the content of this inventory and of any further given inventories at once.\nTakes additional inventories as input, so the content of many inventories can be read with a single call.") {
+	OutVal(0, RArray<RClass<UFGItemDescriptor>>, types, "Types", "The list of all item types contained in the inventories.")
+	OutVal(1, RArray<RInt>, totals, "Totals", "The total amount of items of the item type at the same index in the type list, across all inventories.")
+	OutVal(2, RArray<RInt>, stacks, "Stacks", "Flat list with four entries per non-empty stack: the inventory number (1 = this inventory, 2 = the first given inventory, ...), the stack index, the index of the item type in the type list and the amount of items in the stack.")
+	Body()
+	TArray<UFGInventoryComponent*> Inventories = {self};
+	for (int i = 3; i < Params.Num(); ++i) {
+		Inventories.Add(Cast<UFGInventoryComponent>(Params[i].GetObj()));
+	}
+	TMap<UClass*, int64> TypeIndices;
+	TArray<FINAny> Types;
+	TArray<int64> Totals;
+	TArray<FINAny> Stacks;
+	for (int InventoryNum = 0; InventoryNum < Inventories.Num(); ++InventoryNum) {
+		UFGInventoryComponent* Inventory = Inventories[InventoryNum];
+		if (!IsValid(Inventory)) continue;
+		if (Inventory->GetOwner()->Implements<UFGReplicationDetailActorOwnerInterface>()) {
+			AFGReplicationDetailActor* RepDetailActor = Cast<IFGReplicationDetailActorOwnerInterface>(Inventory->GetOwner())->GetReplicationDetailActor();
+			if (RepDetailActor) {
+				RepDetailActor->FlushReplicationActorStateToOwner();
+			}
+		}
+		const int Size = Inventory->GetSizeLinear();
+		for (int Index = 0; Index < Size; ++Index) {
+			FInventoryStack Stack;
+			if (!Inventory->GetStackFromIndex(Index, Stack) || !Stack.HasItems()) continue;
+			int64* TypeIndex = TypeIndices.Find(Stack.Item.ItemClass);
+			if (!TypeIndex) {
+				TypeIndex = &TypeIndices.Add(Stack.Item.ItemClass, Types.Add((FINClass)Stack.Item.ItemClass));
+				Totals.Add(0);
+			}
+			Totals[*TypeIndex] += Stack.NumItems;
+			Stacks.Add((FINInt)InventoryNum+1);
+			Stacks.Add((FINInt)Index);
+			Stacks.Add((FINInt)*TypeIndex+1);
+			Stacks.Add((FINInt)Stack.NumItems);
+		}
+	}
+	types = Types;
+	TArray<FINAny> TotalsArray;
+	TotalsArray.Reserve(Totals.Num());
+	for (int64 Total : Totals) {
+		TotalsArray.Add(Total);
+	}
+	totals = TotalsArray;
+	stacks = Stacks;
+} EndFunc()
 BeginProp(RInt, itemCount, "Item Count", "The absolute amount of items in the whole inventory.") {
 	if (self->GetOwner()->Implements<UFGReplicationDetailActorOwnerInterface>()) {
 		AFGReplicationDetailActor* RepDetailActor = Cast<IFGReplicationDetailActorOwnerInterface>(self->GetOwner())->GetReplicationDetailActor();
@@ -1338,6 +1385,7 @@ BeginClass(AFGBuildableTrainPlatform, "TrainPlatform", "Train Platform", "The ba
 BeginFunc(getTrackGraph, "Get Track Graph", "Returns the track graph of which this platform is part of.") {
 	OutVal(0, RStruct<FFINTrackGraph>, graph, "Graph", "The track graph of which this platform is part of.")
 	Body()
+	FFINTrackGraph::CacheSnapshot(self, self->GetTrackGraphID());
 	graph = (FINAny)FFINTrackGraph{Ctx.GetTrace(), self->GetTrackGraphID()};
 } EndFunc()
 BeginFunc(getTrackPos, "Get Track Pos", "Returns the track pos at which this train platform is placed.") {
@@ -1436,6 +1484,7 @@ BeginFunc(getCoupled, "Get Coupled", "Allows to get the coupled vehicle at the g
 BeginFunc(getTrackGraph, "Get Track Graph", "Returns the track graph of which this vehicle is part of.") {
 	OutVal(0, RStruct<FFINTrackGraph>, track, "Track", "The track graph of which this vehicle is part of.")
 	Body()
+	FFINTrackGraph::CacheSnapshot(self, self->GetTrackGraphID());
 	track = (FINAny)FFINTrackGraph{Ctx.GetTrace(), self->GetTrackGraphID()};
 } EndFunc()
 BeginFunc(getTrackPos, "Get Track Pos", "Returns the track pos at which this vehicle is.") {
@@ -1604,6 +1653,7 @@ BeginFunc(setName, "Set Name", "Allows to set the name of this train.") {
 BeginFunc(getTrackGraph, "Get Track Graph", "Returns the track graph of which this train is part of.") {
 	OutVal(0, RStruct<FFINTrackGraph>, track, "Track", "The track graph of which this train is part of.")
 	Body()
+	FFINTrackGraph::CacheSnapshot(self, self->GetTrackGraphID());
 	track = (FINAny) FFINTrackGraph{Ctx.GetTrace(), self->GetTrackGraphID()};
 } EndFunc()
 BeginFunc(setSelfDriving, "Set Self Driving", "Allows to set if the train should be self driving or not.") {
@@ -1779,6 +1829,7 @@ BeginFunc(getConnection, "Get Connection", "Returns the railroad track connectio
 BeginFunc(getTrackGraph, "Get Track Graph", "Returns the track graph of which this track is part of.") {
 	OutVal(0, RStruct<FFINTrackGraph>, track, "Track", "The track graph of which this track is part of.")
     Body()
+    FFINTrackGraph::CacheSnapshot(self, self->GetTrackGraphID());
     track = (FINAny)FFINTrackGraph{Ctx.GetTrace(), self->GetTrackGraphID()};
 } EndFunc()
 BeginProp(RFloat, length, "Length", "The length of the track.") {
@@ -2472,6 +2523,103 @@ BeginFunc(getStations, "Get Stations", "Returns a list of all trainstations in t
 	}
 	stations = Stations;
 } EndFunc()
+BeginFunc(findPath, "Find Path", "Searches the shortest path between the two given track positions. The search runs on a cached snapshot of the track graph, switches are considered in all their positions.", 2) {
+	InVal(0, RTrace<AFGBuildableRailroadTrack>, startTrack, "Start Track", "The track of the start position.")
+	InVal(1, RFloat, startOffset, "Start Offset", "The offset of the start position.")
+	InVal(2, RFloat, startForward, "Start Forward", "The direction in which the path has to leave the start position. 1 = with the track direction, -1 = against the track direction, 0 = any direction")
+	InVal(3, RTrace<AFGBuildableRailroadTrack>, endTrack, "End Track", "The track of the end position.")
+	InVal(4, RFloat, endOffset, "End Offset", "The offset of the end position.")
+	InVal(5, RFloat, endForward, "End Forward", "The direction in which the path has to arrive at the end position. 1 = with the track direction, -1 = against the track direction, 0 = any direction")
+	OutVal(6, RBool, found, "Found", "True if a path between the two positions was found.")
+	OutVal(7, RFloat, distance, "Distance", "The length of the found path.")
+	OutVal(8, RArray<RTrace<AFGBuildableRailroadTrack>>, tracks, "Tracks", "The list of tracks the found path leads over, beginning with the start track and ending with the end track.")
+	Body()
+	TSharedRef<const FFINTrackGraphSnapshot> Snapshot = self->GetSnapshot();
+	const int32* StartIndex = Snapshot->TrackIndices.Find(Cast<AFGBuildableRailroadTrack>(startTrack.Get()));
+	if (!StartIndex) throw FFINException("Start track is not part of the track graph");
+	const int32* EndIndex = Snapshot->TrackIndices.Find(Cast<AFGBuildableRailroadTrack>(endTrack.Get()));
+	if (!EndIndex) throw FFINException("End track is not part of the track graph");
+	float Distance = 0.0f;
+	TArray<int32> PathTracks;
+	found = Snapshot->FindPath(FFINTrackGraphPosition{*StartIndex, (float)startOffset, (float)FMath::Sign(startForward)}, FFINTrackGraphPosition{*EndIndex, (float)endOffset, (float)FMath::Sign(endForward)}, Distance, PathTracks);
+	distance = Distance;
+	TArray<FINAny> Tracks;
+	for (int32 Track : PathTracks) {
+		// the path isn't drivable anymore if a track of it got removed since the snapshot got captured
+		AFGBuildableRailroadTrack* TrackActor = Snapshot->Tracks[Track].Get();
+		if (!TrackActor) FFINTrackGraph::ThrowOutdatedSnapshot(Snapshot);
+		Tracks.Add(self->Trace / TrackActor);
+	}
+	tracks = Tracks;
+} EndFunc()
+BeginFunc(findStationPath, "Find Station Path", "Searches the shortest path between the two given train stations. The search runs on a cached snapshot of the track graph, switches are considered in all their positions.", 2) {
+	InVal(0, RTrace<AFGBuildableRailroadStation>, start, "Start", "The station from which the path should start.")
+	InVal(1, RTrace<AFGBuildableRailroadStation>, end, "End", "The station at which the path should end.")
+	OutVal(2, RBool, found, "Found", "True if a path between the two stations was found.")
+	OutVal(3, RFloat, distance, "Distance", "The length of the found path.")
+	OutVal(4, RArray<RTrace<AFGBuildableRailroadTrack>>, tracks, "Tracks", "The list of tracks the found path leads over, beginning with the track of the start station and ending with the track of the end station.")
+	Body()
+	TSharedRef<const FFINTrackGraphSnapshot> Snapshot = self->GetSnapshot();
+	const int32* StartIndex = Snapshot->StationIndices.Find(Cast<AFGBuildableRailroadStation>(start.Get()));
+	if (!StartIndex) throw FFINException("Start station is not part of the track graph");
+	const int32* EndIndex = Snapshot->StationIndices.Find(Cast<AFGBuildableRailroadStation>(end.Get()));
+	if (!EndIndex) throw FFINException("End station is not part of the track graph");
+	float Distance = 0.0f;
+	TArray<int32> PathTracks;
+	found = Snapshot->FindPath(Snapshot->StationPositions[*StartIndex], Snapshot->StationPositions[*EndIndex], Distance, PathTracks);
+	distance = Distance;
+	TArray<FINAny> Tracks;
+	for (int32 Track : PathTracks) {
+		// the path isn't drivable anymore if a track of it got removed since the snapshot got captured
+		AFGBuildableRailroadTrack* TrackActor = Snapshot->Tracks[Track].Get();
+		if (!TrackActor) FFINTrackGraph::ThrowOutdatedSnapshot(Snapshot);
+		Tracks.Add(self->Trace / TrackActor);
+	}
+	tracks = Tracks;
+} EndFunc()
+BeginFunc(isReachable, "Is Reachable", "Checks if a train is able to drive from the given start station to the given end station. The check runs on a cached snapshot of the track graph, switches are considered in all their positions.", 2) {
+	InVal(0, RTrace<AFGBuildableRailroadStation>, start, "Start", "The station from which a train should start.")
+	InVal(1, RTrace<AFGBuildableRailroadStation>, end, "End", "The station at which a train should arrive.")
+	OutVal(2, RBool, reachable, "Reachable", "True if the end station is reachable from the start station.")
+	Body()
+	TSharedRef<const FFINTrackGraphSnapshot> Snapshot = self->GetSnapshot();
+	const int32* StartIndex = Snapshot->StationIndices.Find(Cast<AFGBuildableRailroadStation>(start.Get()));
+	const int32* EndIndex = Snapshot->StationIndices.Find(Cast<AFGBuildableRailroadStation>(end.Get()));
+	float Distance;
+	TArray<int32> PathTracks;
+	reachable = StartIndex && EndIndex && Snapshot->FindPath(Snapshot->StationPositions[*StartIndex], Snapshot->StationPositions[*EndIndex], Distance, PathTracks);
+	for (int32 Track : PathTracks) {
+		if (!Snapshot->Tracks[Track].IsValid()) FFINTrackGraph::ThrowOutdatedSnapshot(Snapshot);
+	}
+} EndFunc()
+BeginFunc(getStationDistances, "Get Station Distances", "Calculates the shortest driving distances between all the trainstations in the network. The calculation runs on a cached snapshot of the track graph, switches are considered in all their positions.", 2) {
+	OutVal(0, RArray<RTrace<AFGBuildableRailroadStation>>, stations, "Stations", "The list of trainstations in the network.")
+	OutVal(1, RArray<RFloat>, distances, "Distances", "Row major distance matrix, the distance from station i to station j (1 based) is at index (i-1)*#stations+j. Negative if there is no path.")
+	Body()
+	TSharedRef<const FFINTrackGraphSnapshot> Snapshot = self->GetSnapshot();
+	// the distances may lead over any track, checking them all is cheap compared to the searches
+	for (const TWeakObjectPtr<AFGBuildableRailroadTrack>& Track : Snapshot->Tracks) {
+		if (!Track.IsValid()) FFINTrackGraph::ThrowOutdatedSnapshot(Snapshot);
+	}
+	// stations removed since the snapshot got captured are skipped
+	TArray<FINAny> Stations;
+	TArray<FFINTrackGraphPosition> Positions;
+	for (int32 i = 0; i < Snapshot->Stations.Num(); ++i) {
+		AFGBuildableRailroadStation* Station = Snapshot->Stations[i].Get();
+		if (!Station) continue;
+		Stations.Add(self->Trace / Station);
+		Positions.Add(Snapshot->StationPositions[i]);
+	}
+	stations = Stations;
+	TArray<float> DistanceMatrix;
+	Snapshot->GetDistances(Positions, DistanceMatrix);
+	TArray<FINAny> Distances;
+	Distances.Reserve(DistanceMatrix.Num());
+	for (float Distance : DistanceMatrix) {
+		Distances.Add((FINFloat)Distance);
+	}
+	distances = Distances;
+} EndFunc()
 EndStruct()
 
 BeginStruct(FFINTargetPoint, "TargetPoint", "Target Point", "Target Point in the waypoint list of a wheeled vehicle.")
@@ -2,3 +2,61 @@
 
 FCriticalSection UFINFactoryConnectorHook::MutexFactoryGrab;
 TMap<TWeakObjectPtr<UFGFactoryConnectionComponent>, int8> UFINFactoryConnectorHook::FactoryGrabsRunning;
+std::atomic<bool> UFINFactoryConnectorHook::bMeasureGrabs{false};
+std::atomic<bool> UFINFactoryConnectorHook::bSuspendHooks{false};
+std::atomic<uint64> UFINFactoryConnectorHook::GrabCycles{0};
+std::atomic<uint64> UFINFactoryConnectorHook::Grabs{0};
+std::atomic<uint64> UFINFactoryConnectorHook::HookCycles{0};
+std::atomic<uint64> UFINFactoryConnectorHook::HookedGrabs{0};
+
+void UFINFactoryConnectorHook::BeginGrabMeasurement(bool bInSuspendHooks) {
+	GrabCycles.store(0);
+	Grabs.store(0);
+	HookCycles.store(0);
+	HookedGrabs.store(0);
+	bSuspendHooks.store(bInSuspendHooks);
+	bMeasureGrabs.store(true);
+}
+
+FFINFactoryGrabMeasurement UFINFactoryConnectorHook::EndGrabMeasurement() {
+	bMeasureGrabs.store(false);
+	bSuspendHooks.store(false);
+	FFINFactoryGrabMeasurement Measurement;
+	Measurement.Grabs = Grabs.load();
+	Measurement.GrabTime = FPlatformTime::ToSeconds64(GrabCycles.load());
+	Measurement.HookedGrabs = HookedGrabs.load();
+	Measurement.HookTime = FPlatformTime::ToSeconds64(HookCycles.load());
+	return Measurement;
+}
+
+static FString FormatGrabMeasurement(const FFINFactoryGrabMeasurement& Measurement, float Seconds) {
+	return FString::Printf(TEXT("%llu grabs, %.2fns per grab, %.3fms per second spent in grabs"), Measurement.Grabs, Measurement.GrabTime * 1e9 / FMath::Max<uint64>(1, Measurement.Grabs), Measurement.GrabTime * 1e3 / Seconds);
+}
+
+static FAutoConsoleCommand BenchmarkFactoryHooksCommand(
+	TEXT("FIN.BenchmarkFactoryHooks"),
+	TEXT("Measures the time the FIN factory connector hooks add to the factory grabs of the running game, without changing the attached hooks. "
+		"With Compare, measures the grabs once with the hooks and then once more with the hooks suspended, no ItemTransfer signals get sent during the second measurement. Args: [Seconds=10] [Compare]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+		float Seconds = 10.0f;
+		if (Args.Num() > 0 && Args[0].IsNumeric()) Seconds = FMath::Max(0.1f, FCString::Atof(*Args[0]));
+		const bool bCompare = Args.Contains(TEXT("Compare"));
+
+		UFINFactoryConnectorHook::BeginGrabMeasurement();
+		FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Seconds, bCompare](float) {
+			const FFINFactoryGrabMeasurement WithHooks = UFINFactoryConnectorHook::EndGrabMeasurement();
+			if (!bCompare) {
+				UE_LOG(LogFicsItNetworks, Display, TEXT("Factory hook benchmark over %.1fs: %s, %llu hooked grabs, %.2fns per hooked grab, %.3fms per second spent in the hooks"), Seconds, *FormatGrabMeasurement(WithHooks, Seconds), WithHooks.HookedGrabs, WithHooks.HookTime * 1e9 / FMath::Max<uint64>(1, WithHooks.HookedGrabs), WithHooks.HookTime * 1e3 / Seconds);
+				return false;
+			}
+			
+			UE_LOG(LogFicsItNetworks, Display, TEXT("Factory hook benchmark: suspending the factory connector hooks for %.1fs"), Seconds);
+			UFINFactoryConnectorHook::BeginGrabMeasurement(true);
+			FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Seconds, WithHooks](float) {
+				const FFINFactoryGrabMeasurement WithoutHooks = UFINFactoryConnectorHook::EndGrabMeasurement();
+				UE_LOG(LogFicsItNetworks, Display, TEXT("Factory hook benchmark over %.1fs each: with hooks %s (%llu hooked); without hooks %s"), Seconds, *FormatGrabMeasurement(WithHooks, Seconds), WithHooks.HookedGrabs, *FormatGrabMeasurement(WithoutHooks, Seconds));
+				return false;
+			}), Seconds);
+			return false;
+		}), Seconds);
+	}));
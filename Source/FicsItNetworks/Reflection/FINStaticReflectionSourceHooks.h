@@ -10,9 +10,27 @@
 #include "Buildables/FGBuildableRailroadSignal.h"
 #include "FicsItNetworks/Network/FINHookSubsystem.h"
 #include "Patching/NativeHookManager.h"
+#include <atomic>
 
 #include "FINStaticReflectionSourceHooks.generated.h"
 
+/**
+ * Timings of the factory grabs collected by the factory connector hooks
+ */
+struct FFINFactoryGrabMeasurement {
+	/**
+	 * The amount of grabs and the time they took in seconds, including the hooked grab itself
+	 */
+	uint64 Grabs = 0;
+	double GrabTime = 0.0;
+
+	/**
+	 * The amount of grabs of connectors with listeners and the time the hooks spent on their own work in seconds
+	 */
+	uint64 HookedGrabs = 0;
+	double HookTime = 0.0;
+};
+
 UCLASS()
 class FICSITNETWORKS_API UFINStaticReflectionHook : public UFINHook {
 	GENERATED_BODY()
@@ -55,8 +73,22 @@ protected:
 	UPROPERTY()
 	TSet<TWeakObjectPtr<UObject>> Senders;
 	FCriticalSection Mutex;
+
+	/**
+	 * Counts the registered senders per object-index bucket.
+	 * Allows IsSender to reject objects nobody listens to without taking the lock,
+	 * the Senders set only gets checked if the bucket of the object is in use.
+	 */
+	static constexpr int32 SenderBucketCount = 1 << 14;
+	TUniquePtr<std::atomic<int32>[]> SenderBuckets;
+	int32 SenderBucket = INDEX_NONE;
+
+	static int32 GetSenderBucket(UObject* Obj) {
+		return Obj->GetUniqueID() & (SenderBucketCount - 1);
+	}
 	
 	bool IsSender(UObject* Obj) {
+		if (SenderBuckets && SenderBuckets[GetSenderBucket(Obj)].load(std::memory_order_acquire) <= 0) return false;
 		FScopeLock Lock(&Mutex);
 		return Senders.Contains(Obj);
 	}
@@ -74,12 +106,22 @@ protected:
 
 	virtual UFINFunctionHook* Self() { return nullptr; }
 
-public:		
+public:
+	UFINFunctionHook() {
+		// only the default object is used as shared sender registry, so only it needs the buckets
+		if (HasAnyFlags(RF_ClassDefaultObject)) {
+			SenderBuckets = MakeUnique<std::atomic<int32>[]>(SenderBucketCount);
+			for (int32 i = 0; i < SenderBucketCount; ++i) SenderBuckets[i].store(0);
+		}
+	}
+	
 	void Register(UObject* sender) override {
 		Super::Register(sender);
 		
 		FScopeLock Lock(&Self()->Mutex);
     	Self()->Senders.Add(Sender = sender);
+		SenderBucket = GetSenderBucket(sender);
+		Self()->SenderBuckets[SenderBucket].fetch_add(1, std::memory_order_release);
 
 		if (!Self()->bIsRegistered) {
 			Self()->bIsRegistered = true;
@@ -90,6 +132,10 @@ public:
 	void Unregister() override {
 		FScopeLock Lock(&Self()->Mutex);
     	Self()->Senders.Remove(Sender);
+		if (SenderBucket != INDEX_NONE) {
+			Self()->SenderBuckets[SenderBucket].fetch_sub(1, std::memory_order_release);
+			SenderBucket = INDEX_NONE;
+		}
     }
 };
 
@@ -182,25 +228,114 @@ private:
 		StaticSelf()->Send(c, "ItemTransfer", {FINAny(FInventoryItem(item))});
 	}
 
+	static std::atomic<bool> bMeasureGrabs;
+	static std::atomic<bool> bSuspendHooks;
+	static std::atomic<uint64> GrabCycles;
+	static std::atomic<uint64> Grabs;
+	static std::atomic<uint64> HookCycles;
+	static std::atomic<uint64> HookedGrabs;
+
+	/**
+	 * The amount of grabs currently running in this thread, grabs can call other hooked grabs
+	 */
+	static int32& GetGrabDepth() {
+		static thread_local int32 Depth = 0;
+		return Depth;
+	}
+
+	/**
+	 * Measures the time of a whole grab and the time the grab hook spends on its own work, excluding the hooked grab itself,
+	 * and adds them to the grab statistics if they are getting collected.
+	 * Only the outermost grab of a thread counts towards the grab time, so nested grabs aren't counted twice.
+	 */
+	struct FGrabTimer {
+		bool bEnabled;
+		bool bOutermost = false;
+		bool bHooked = false;
+		uint64 GrabStart = 0;
+		uint64 Start = 0;
+		uint64 Cycles = 0;
+
+		FGrabTimer() : bEnabled(bMeasureGrabs.load(std::memory_order_relaxed)) {
+			if (!bEnabled) return;
+			bOutermost = GetGrabDepth()++ == 0;
+			GrabStart = Start = FPlatformTime::Cycles64();
+		}
+
+		~FGrabTimer() {
+			if (!bEnabled) return;
+			Pause();
+			--GetGrabDepth();
+			if (bOutermost) {
+				GrabCycles.fetch_add(FPlatformTime::Cycles64() - GrabStart, std::memory_order_relaxed);
+				Grabs.fetch_add(1, std::memory_order_relaxed);
+			}
+			if (!bHooked) return;
+			HookCycles.fetch_add(Cycles, std::memory_order_relaxed);
+			HookedGrabs.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Pause() {
+			if (bEnabled) Cycles += FPlatformTime::Cycles64() - Start;
+		}
+
+		void Resume() {
+			if (bEnabled) Start = FPlatformTime::Cycles64();
+		}
+	};
+
+	static bool ShouldHookGrab(UFGFactoryConnectionComponent* c) {
+		return !bSuspendHooks.load(std::memory_order_relaxed) && StaticSelf()->IsSender(c);
+	}
+
 	static void FactoryGrabHook(CallScope<bool(*)(UFGFactoryConnectionComponent*, FInventoryItem&, float&, TSubclassOf<UFGItemDescriptor>)>& scope, UFGFactoryConnectionComponent* c, FInventoryItem& item, float& offset, TSubclassOf<UFGItemDescriptor> type) {
-		if (!StaticSelf()->IsSender(c)) return;
+		FGrabTimer Timer;
+		if (!ShouldHookGrab(c)) {
+			// while measuring, call the grab here so its time is included
+			if (Timer.bEnabled) scope(c, item, offset, type);
+			return;
+		}
+		Timer.bHooked = true;
 		LockFactoryGrab(c);
+		Timer.Pause();
 		scope(c, item, offset, type);
+		Timer.Resume();
 		if (UnlockFactoryGrab(c) && scope.getResult()) {
 			DoFactoryGrab(c, item);
 		}
 	}
 
 	static void FactoryGrabInternalHook(CallScope<bool(*)(UFGFactoryConnectionComponent*, FInventoryItem&, TSubclassOf<UFGItemDescriptor>)>& scope, UFGFactoryConnectionComponent* c, FInventoryItem& item, TSubclassOf< UFGItemDescriptor > type) {
-		if (!StaticSelf()->IsSender(c)) return;
+		FGrabTimer Timer;
+		if (!ShouldHookGrab(c)) {
+			if (Timer.bEnabled) scope(c, item, type);
+			return;
+		}
+		Timer.bHooked = true;
 		LockFactoryGrab(c);
+		Timer.Pause();
 		scope(c, item, type);
+		Timer.Resume();
 		if (UnlockFactoryGrab(c) && scope.getResult()) {
 			DoFactoryGrab(c, item);
 		}
 	}
 			
-public:		
+public:
+	/**
+	 * Starts to collect the time of the grabs in the real factory tick and the time the grab hooks spend on them.
+	 * The listeners stay untouched, but if bInSuspendHooks is set the hooks skip their work until the measurement ends,
+	 * so the grabs can be compared to grabs without attached hooks. No ItemTransfer signals get sent while they are suspended.
+	 */
+	static void BeginGrabMeasurement(bool bInSuspendHooks = false);
+
+	/**
+	 * Stops collecting the grab timings and resumes suspended hooks.
+	 *
+	 * @return	the timings collected since the measurement began
+	 */
+	static FFINFactoryGrabMeasurement EndGrabMeasurement();
+	
 	void RegisterFuncHook() override {
 		// TODO: Check if this works now
 		// SUBSCRIBE_METHOD_MANUAL("?Factory_GrabOutput@UFGFactoryConnectionComponent@@QEAA_NAEAUFInventoryItem@@AEAMV?$TSubclassOf@VUFGItemDescriptor@@@@@Z", UFGFactoryConnectionComponent::Factory_GrabOutput, &FactoryGrabHook);
@@ -3,6 +3,7 @@
 #include "FINArrayProperty.h"
 #include "FINFuncProperty.h"
 #include "FINReflection.h"
+#include "FINReflectionMetaCache.h"
 #include "FINStructProperty.h"
 #include "FINUFunction.h"
 #include "Buildables/FGBuildable.h"
@@ -36,13 +37,7 @@ bool UFINUReflectionSource::ProvidesRequirements(UScriptStruct* Struct) const {
 void UFINUReflectionSource::FillData(FFINReflection* Ref, UFINClass* ToFillClass, UClass* Class) const {
 	UFINClass* DirectParent = Ref->FindClass(Class->GetSuperClass(), false, false);
 	if (DirectParent) {
-		int childCount = 0;
-		for(TObjectIterator<UClass> It; It; ++It) {
-			if(It->IsChildOf(Class->GetSuperClass())) {
-				childCount++;
-			}
-		}
-		if (childCount < 2) {
+		if (Ref->GetClassChildCount(Class->GetSuperClass()) < 2) {
 			const_cast<TMap<UClass*, UFINClass*>*>(&Ref->GetClasses())->Remove(Class);
 			ToFillClass = DirectParent;
 		}
@@ -89,6 +84,42 @@ void UFINUReflectionSource::FillData(FFINReflection* Ref, UFINStruct* ToFillStru
 }
 
 UFINUReflectionSource::FFINTypeMeta UFINUReflectionSource::GetClassMeta(UClass* Class) const {
+	FFINReflectionMetaCache& Cache = FFINReflectionMetaCache::Get();
+	const FString Key = Class->GetPathName();
+	const FFINTypeMeta* Cached = Cache.ClassMetas.Find(Key);
+	if (Cached) return *Cached;
+	
+	FFINTypeMeta Meta = GenerateClassMeta(Class);
+	Cache.ClassMetas.Add(Key, Meta);
+	Cache.bDirty = true;
+	return Meta;
+}
+
+UFINUReflectionSource::FFINFunctionMeta UFINUReflectionSource::GetFunctionMeta(UClass* Class, UFunction* Func) const {
+	FFINReflectionMetaCache& Cache = FFINReflectionMetaCache::Get();
+	const FString Key = Class->GetPathName() + TEXT(":") + Func->GetName();
+	const FFINFunctionMeta* Cached = Cache.FunctionMetas.Find(Key);
+	if (Cached) return *Cached;
+	
+	FFINFunctionMeta Meta = GenerateFunctionMeta(Class, Func);
+	Cache.FunctionMetas.Add(Key, Meta);
+	Cache.bDirty = true;
+	return Meta;
+}
+
+UFINUReflectionSource::FFINSignalMeta UFINUReflectionSource::GetSignalMeta(UClass* Class, UFunction* Func) const {
+	FFINReflectionMetaCache& Cache = FFINReflectionMetaCache::Get();
+	const FString Key = Class->GetPathName() + TEXT(":") + Func->GetName();
+	const FFINSignalMeta* Cached = Cache.SignalMetas.Find(Key);
+	if (Cached) return *Cached;
+	
+	FFINSignalMeta Meta = GenerateSignalMeta(Class, Func);
+	Cache.SignalMetas.Add(Key, Meta);
+	Cache.bDirty = true;
+	return Meta;
+}
+
+UFINUReflectionSource::FFINTypeMeta UFINUReflectionSource::GenerateClassMeta(UClass* Class) const {
 	FFINTypeMeta Meta;
 
 	Meta.InternalName = Class->GetName();
@@ -159,7 +190,7 @@ UFINUReflectionSource::FFINTypeMeta UFINUReflectionSource::GetClassMeta(UClass*
 	return Meta;
 }
 
-UFINUReflectionSource::FFINFunctionMeta UFINUReflectionSource::GetFunctionMeta(UClass* Class, UFunction* Func) const {
+UFINUReflectionSource::FFINFunctionMeta UFINUReflectionSource::GenerateFunctionMeta(UClass* Class, UFunction* Func) const {
 	FFINFunctionMeta Meta;
 
 	// try to get meta from function
@@ -221,7 +252,7 @@ UFINUReflectionSource::FFINFunctionMeta UFINUReflectionSource::GetFunctionMeta(U
 	return Meta;
 }
 
-UFINUReflectionSource::FFINSignalMeta UFINUReflectionSource::GetSignalMeta(UClass* Class, UFunction* Func) const {
+UFINUReflectionSource::FFINSignalMeta UFINUReflectionSource::GenerateSignalMeta(UClass* Class, UFunction* Func) const {
 	FFINSignalMeta Meta;
 
 	// try to get meta from function
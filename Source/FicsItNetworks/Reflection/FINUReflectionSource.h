@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "FINReflectionMetaCache.h"
 #include "FINReflectionSource.h"
 #include "FINUReflectionSource.generated.h"
 
@@ -8,38 +9,20 @@ UCLASS()
 class FICSITNETWORKS_API UFINUReflectionSource : public UFINReflectionSource {
 	GENERATED_BODY()
 protected:
-	struct FFINTypeMeta {
-		FString InternalName;
-		FText DisplayName;
-		FText Description;
-		TMap<FString, FString> PropertyInternalNames;
-		TMap<FString, FText> PropertyDisplayNames;
-		TMap<FString, FText> PropertyDescriptions;
-		TMap<FString, int> PropertyRuntimes;
-	};
+	typedef FFINReflectionTypeMeta FFINTypeMeta;
+	typedef FFINReflectionFunctionMeta FFINFunctionMeta;
+	typedef FFINReflectionSignalMeta FFINSignalMeta;
 
-	struct FFINFunctionMeta {
-		FString InternalName;
-		FText DisplayName;
-		FText Description;
-		TArray<FString> ParameterInternalNames;
-		TArray<FText> ParameterDescriptions;
-		TArray<FText> ParameterDisplayNames;
-		int Runtime = 1;
-	};
-
-	struct FFINSignalMeta {
-		FString InternalName;
-		FText DisplayName;
-		FText Description;
-		TArray<FString> ParameterInternalNames;
-		TArray<FText> ParameterDescriptions;
-		TArray<FText> ParameterDisplayNames;
-	};
-	
+	/**
+	 * Get the meta data of the given class/function/signal from the meta cache,
+	 * or executes the meta functions and adds the result to the cache.
+	 */
 	FFINTypeMeta GetClassMeta(UClass* Class) const;
 	FFINFunctionMeta GetFunctionMeta(UClass* Class, UFunction* Func) const;
 	FFINSignalMeta GetSignalMeta(UClass* Class, UFunction* Func) const;
+	FFINTypeMeta GenerateClassMeta(UClass* Class) const;
+	FFINFunctionMeta GenerateFunctionMeta(UClass* Class, UFunction* Func) const;
+	FFINSignalMeta GenerateSignalMeta(UClass* Class, UFunction* Func) const;
 	FString GetFunctionNameFromUFunction(UFunction* Func) const;
 	FString GetPropertyNameFromUFunction(UFunction* Func) const;
 	FString GetPropertyNameFromUProperty(UProperty* Prop, bool& bReadOnly) const;
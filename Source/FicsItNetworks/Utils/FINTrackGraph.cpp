@@ -1,9 +1,176 @@
 ﻿#include "FINTrackGraph.h"
 
+#include "EngineUtils.h"
+#include "Algo/Reverse.h"
+#include "FGRailroadSubsystem.h"
+#include "FGRailroadTrackConnectionComponent.h"
 #include "FGRailroadVehicle.h"
 #include "FGTrain.h"
+#include "FGTrainStationIdentifier.h"
+#include "FINException.h"
+#include "Buildables/FGBuildableRailroadStation.h"
+#include "Buildables/FGBuildableRailroadTrack.h"
 #include "Buildables/FGBuildableTrainPlatform.h"
 
+FCriticalSection FFINTrackGraph::SnapshotCacheMutex;
+TMap<int, TSharedRef<const FFINTrackGraphSnapshot>> FFINTrackGraph::SnapshotCache;
+TMap<TWeakObjectPtr<UWorld>, FDelegateHandle> FFINTrackGraph::ObservedWorlds;
+
+TSharedRef<FFINTrackGraphSnapshot> FFINTrackGraphSnapshot::Capture(UWorld* World, int32 TrackID) {
+	TSharedRef<FFINTrackGraphSnapshot> Snapshot = MakeShared<FFINTrackGraphSnapshot>();
+	Snapshot->TrackID = TrackID;
+	Snapshot->World = World;
+
+	for (TActorIterator<AFGBuildableRailroadTrack> Track(World); Track; ++Track) {
+		if (Track->GetTrackGraphID() != TrackID) continue;
+		Snapshot->TrackIndices.Add(*Track, Snapshot->Tracks.Add(*Track));
+		Snapshot->TrackLengths.Add(Track->GetLength());
+	}
+
+	Snapshot->ConnectedNodes.SetNum(Snapshot->Tracks.Num() * 2);
+	for (int32 i = 0; i < Snapshot->Tracks.Num(); ++i) {
+		AFGBuildableRailroadTrack* Track = Snapshot->Tracks[i].Get();
+		for (int32 Side = 0; Side < 2; ++Side) {
+			UFGRailroadTrackConnectionComponent* Connection = Track->GetConnection(Side);
+			if (!Connection) continue;
+			for (UFGRailroadTrackConnectionComponent* Connected : Connection->GetConnections()) {
+				if (!Connected) continue;
+				AFGBuildableRailroadTrack* ConnectedTrack = Connected->GetTrack();
+				const int32* ConnectedIndex = Snapshot->TrackIndices.Find(ConnectedTrack);
+				if (!ConnectedIndex) continue;
+				const int32 ConnectedSide = ConnectedTrack->GetConnection(0) == Connected ? 0 : 1;
+				Snapshot->ConnectedNodes[i*2 + Side].Add(*ConnectedIndex*2 + ConnectedSide);
+			}
+		}
+	}
+
+	TArray<AFGTrainStationIdentifier*> StationList;
+	AFGRailroadSubsystem::Get(World)->GetTrainStations(TrackID, StationList);
+	for (AFGTrainStationIdentifier* Identifier : StationList) {
+		AFGBuildableRailroadStation* Station = Identifier ? Identifier->mStation : nullptr;
+		if (!Station) continue;
+		FRailroadTrackPosition Pos = Station->GetTrackPosition();
+		const int32* TrackIndex = Snapshot->TrackIndices.Find(Pos.Track.Get());
+		if (!TrackIndex) continue;
+		Snapshot->StationIndices.Add(Station, Snapshot->Stations.Add(Station));
+		Snapshot->StationPositions.Add(FFINTrackGraphPosition{*TrackIndex, Pos.Offset, 0.0f});
+	}
+
+	return Snapshot;
+}
+
+struct FFINTrackGraphQueueEntry {
+	float Distance;
+	int32 Node;
+
+	bool operator<(const FFINTrackGraphQueueEntry& Other) const {
+		return Distance < Other.Distance;
+	}
+};
+
+void FFINTrackGraphSnapshot::Dijkstra(const FFINTrackGraphPosition& From, TArray<float>& OutDistances, TArray<int32>& OutPrevious, TFunctionRef<bool(float)> ShouldContinue) const {
+	OutDistances.Init(TNumericLimits<float>::Max(), ConnectedNodes.Num());
+	OutPrevious.Init(INDEX_NONE, ConnectedNodes.Num());
+	TArray<FFINTrackGraphQueueEntry> Queue;
+
+	// leave the start track in the allowed directions
+	for (int32 Side = 0; Side < 2; ++Side) {
+		if ((Side == 1 && From.Forward < 0.0f) || (Side == 0 && From.Forward > 0.0f)) continue;
+		const float Distance = Side == 1 ? TrackLengths[From.Track] - From.Offset : From.Offset;
+		for (int32 Node : ConnectedNodes[From.Track*2 + Side]) {
+			if (Distance >= OutDistances[Node]) continue;
+			OutDistances[Node] = Distance;
+			Queue.HeapPush(FFINTrackGraphQueueEntry{Distance, Node});
+		}
+	}
+
+	while (Queue.Num() > 0) {
+		FFINTrackGraphQueueEntry Entry;
+		Queue.HeapPop(Entry, false);
+		if (Entry.Distance > OutDistances[Entry.Node]) continue;
+		if (!ShouldContinue(Entry.Distance)) break;
+
+		// drive over the entered track and leave it through the other side
+		const int32 Track = Entry.Node / 2;
+		const int32 ExitNode = Track*2 + (1 - Entry.Node % 2);
+		const float Distance = Entry.Distance + TrackLengths[Track];
+		for (int32 Node : ConnectedNodes[ExitNode]) {
+			if (Distance >= OutDistances[Node]) continue;
+			OutDistances[Node] = Distance;
+			OutPrevious[Node] = Entry.Node;
+			Queue.HeapPush(FFINTrackGraphQueueEntry{Distance, Node});
+		}
+	}
+}
+
+float FFINTrackGraphSnapshot::GetDistanceTo(const FFINTrackGraphPosition& From, const FFINTrackGraphPosition& To, const TArray<float>& Distances, int32& OutEntryNode) const {
+	float Best = TNumericLimits<float>::Max();
+	OutEntryNode = INDEX_NONE;
+
+	// directly on the same track without leaving it
+	if (From.Track == To.Track) {
+		if (From.Forward >= 0.0f && To.Forward >= 0.0f && To.Offset >= From.Offset) Best = FMath::Min(Best, To.Offset - From.Offset);
+		if (From.Forward <= 0.0f && To.Forward <= 0.0f && To.Offset <= From.Offset) Best = FMath::Min(Best, From.Offset - To.Offset);
+	}
+
+	// enter the target track through one of its sides
+	for (int32 Side = 0; Side < 2; ++Side) {
+		if ((Side == 0 && To.Forward < 0.0f) || (Side == 1 && To.Forward > 0.0f)) continue;
+		const int32 Node = To.Track*2 + Side;
+		if (Distances[Node] == TNumericLimits<float>::Max()) continue;
+		const float Distance = Distances[Node] + (Side == 0 ? To.Offset : TrackLengths[To.Track] - To.Offset);
+		if (Distance < Best) {
+			Best = Distance;
+			OutEntryNode = Node;
+		}
+	}
+	
+	return Best;
+}
+
+bool FFINTrackGraphSnapshot::FindPath(const FFINTrackGraphPosition& From, const FFINTrackGraphPosition& To, float& OutDistance, TArray<int32>& OutTracks) const {
+	OutTracks.Empty();
+	if (!Tracks.IsValidIndex(From.Track) || !Tracks.IsValidIndex(To.Track)) return false;
+	
+	TArray<float> Distances;
+	TArray<int32> Previous;
+	int32 EntryNode;
+	Dijkstra(From, Distances, Previous, [&](float Distance) {
+		// no shorter path can be found once the queue reached the currently best distance
+		return Distance < GetDistanceTo(From, To, Distances, EntryNode);
+	});
+	
+	OutDistance = GetDistanceTo(From, To, Distances, EntryNode);
+	if (OutDistance == TNumericLimits<float>::Max()) return false;
+
+	for (int32 Node = EntryNode; Node != INDEX_NONE; Node = Previous[Node]) {
+		OutTracks.Add(Node / 2);
+	}
+	OutTracks.Add(From.Track);
+	Algo::Reverse(OutTracks);
+	return true;
+}
+
+void FFINTrackGraphSnapshot::GetDistances(const TArray<FFINTrackGraphPosition>& Positions, TArray<float>& OutDistances) const {
+	OutDistances.Init(-1.0f, Positions.Num() * Positions.Num());
+	TArray<float> Distances;
+	TArray<int32> Previous;
+	for (int32 i = 0; i < Positions.Num(); ++i) {
+		if (!Tracks.IsValidIndex(Positions[i].Track)) continue;
+		Dijkstra(Positions[i], Distances, Previous, [](float) { return true; });
+		for (int32 j = 0; j < Positions.Num(); ++j) {
+			if (!Tracks.IsValidIndex(Positions[j].Track)) continue;
+			if (i == j) {
+				OutDistances[i * Positions.Num() + j] = 0.0f;
+				continue;
+			}
+			int32 EntryNode;
+			const float Distance = GetDistanceTo(Positions[i], Positions[j], Distances, EntryNode);
+			if (Distance != TNumericLimits<float>::Max()) OutDistances[i * Positions.Num() + j] = Distance;
+		}
+	}
+}
+
 int FFINTrackGraph::GetTrackID(UObject* obj) {
 	if (AFGBuildableTrainPlatform* platform = Cast<AFGBuildableTrainPlatform>(obj)) {
 		return platform->GetTrackGraphID();
@@ -14,9 +181,72 @@ int FFINTrackGraph::GetTrackID(UObject* obj) {
 	if (AFGTrain* train = Cast<AFGTrain>(obj)) {
 		return train->GetTrackGraphID();
 	}
+	if (AFGBuildableRailroadTrack* track = Cast<AFGBuildableRailroadTrack>(obj)) {
+		return track->GetTrackGraphID();
+	}
 	return -1;
 }
 
 bool FFINTrackGraph::IsValid() {
 	return GetTrackID(*Trace) >= 0;
 }
+
+void FFINTrackGraph::CacheSnapshot(UObject* WorldContext, int TrackID) {
+	UWorld* World = WorldContext->GetWorld();
+	if (!World) return;
+	FScopeLock Lock(&SnapshotCacheMutex);
+
+	// tracks built into an existing graph don't change its ID, so listen for them to drop the affected snapshots
+	if (!ObservedWorlds.Contains(World)) {
+		for (auto It = ObservedWorlds.CreateIterator(); It; ++It) {
+			if (!It->Key.IsValid()) It.RemoveCurrent();
+		}
+		ObservedWorlds.Add(World, World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateStatic(&FFINTrackGraph::OnActorSpawned)));
+	}
+	
+	// getTrackGraph shouldn't cost more than the lookup, removed tracks get detected by the queries instead
+	const TSharedRef<const FFINTrackGraphSnapshot>* Cached = SnapshotCache.Find(TrackID);
+	if (Cached && (*Cached)->World == World) return;
+
+	// the IDs of track graphs change when they get rebuild, so drop the snapshots of graphs that don't exist anymore
+	for (auto It = SnapshotCache.CreateIterator(); It; ++It) {
+		const FFINTrackGraphSnapshot& Snapshot = It->Value.Get();
+		AFGBuildableRailroadTrack* Track = Snapshot.Tracks.Num() > 0 ? Snapshot.Tracks[0].Get() : nullptr;
+		if (!Track || Track->GetTrackGraphID() != Snapshot.TrackID) It.RemoveCurrent();
+	}
+	
+	SnapshotCache.Add(TrackID, FFINTrackGraphSnapshot::Capture(World, TrackID));
+}
+
+void FFINTrackGraph::OnActorSpawned(AActor* Actor) {
+	if (!Cast<AFGBuildableRailroadTrack>(Actor) && !Cast<AFGBuildableRailroadStation>(Actor)) return;
+	UWorld* World = Actor->GetWorld();
+	FScopeLock Lock(&SnapshotCacheMutex);
+	for (auto It = SnapshotCache.CreateIterator(); It; ++It) {
+		if (It->Value->World == World) It.RemoveCurrent();
+	}
+}
+
+TSharedRef<const FFINTrackGraphSnapshot> FFINTrackGraph::GetSnapshot() {
+	// the actors may only be accessed in the game thread, outside of it we have to rely on the snapshot captured in sync
+	if (IsInGameThread()) {
+		UObject* Obj = *Trace;
+		if (!Obj) throw FFINException(TEXT("Track graph is invalid"));
+		if (GetTrackID(Obj) != TrackID) throw FFINException(TEXT("Track graph is outdated, get the track graph again"));
+		CacheSnapshot(Obj, TrackID);
+	}
+	
+	FScopeLock Lock(&SnapshotCacheMutex);
+	const TSharedRef<const FFINTrackGraphSnapshot>* Snapshot = SnapshotCache.Find(TrackID);
+	if (!Snapshot) throw FFINException(TEXT("Track graph is not cached, get the track graph again"));
+	return *Snapshot;
+}
+
+void FFINTrackGraph::ThrowOutdatedSnapshot(const TSharedRef<const FFINTrackGraphSnapshot>& Snapshot) {
+	{
+		FScopeLock Lock(&SnapshotCacheMutex);
+		const TSharedRef<const FFINTrackGraphSnapshot>* Cached = SnapshotCache.Find(Snapshot->TrackID);
+		if (Cached && *Cached == Snapshot) SnapshotCache.Remove(Snapshot->TrackID);
+	}
+	throw FFINException(TEXT("Track graph is outdated, get the track graph again"));
+}
@@ -4,6 +4,75 @@
 #include "FicsItNetworks/Network/FINNetworkTrace.h"
 #include "FINTrackGraph.generated.h"
 
+class AFGBuildableRailroadTrack;
+class AFGBuildableRailroadStation;
+
+/**
+ * A position on a track of a track graph snapshot.
+ * Forward is 1 if the position points in the direction of the track, -1 if it points against it
+ * and 0 if both directions are allowed.
+ */
+struct FICSITNETWORKS_API FFINTrackGraphPosition {
+	int32 Track = INDEX_NONE;
+	float Offset = 0.0f;
+	float Forward = 0.0f;
+};
+
+/**
+ * Immutable adjacency snapshot of a whole track graph.
+ * Gets captured once in sync with the game thread and can then be used for path queries from any thread
+ * without touching the game world.
+ * The nodes of the graph are the track connections, node "Track*2 + Side" is the connection at the given side of the track.
+ * Entering a track through one side and leaving it through the other side costs the length of the track.
+ */
+struct FICSITNETWORKS_API FFINTrackGraphSnapshot {
+	int32 TrackID = INDEX_NONE;
+	TWeakObjectPtr<UWorld> World;
+	
+	TArray<TWeakObjectPtr<AFGBuildableRailroadTrack>> Tracks;
+	TArray<float> TrackLengths;
+	TMap<AFGBuildableRailroadTrack*, int32> TrackIndices;
+
+	/**
+	 * Contains for every connection node the list of connection nodes of other tracks it is connected to.
+	 * Switches are taken into account with all their positions.
+	 */
+	TArray<TArray<int32>> ConnectedNodes;
+
+	TArray<TWeakObjectPtr<AFGBuildableRailroadStation>> Stations;
+	TArray<FFINTrackGraphPosition> StationPositions;
+	TMap<AFGBuildableRailroadStation*, int32> StationIndices;
+
+	/**
+	 * Captures a new snapshot of the track graph with the given ID.
+	 * Has to be called in sync with the game thread.
+	 */
+	static TSharedRef<FFINTrackGraphSnapshot> Capture(UWorld* World, int32 TrackID);
+
+	/**
+	 * Searches the shortest path between the two given positions.
+	 *
+	 * @param[in]	From			the position from which the path should start
+	 * @param[in]	To				the position at which the path should end
+	 * @param[out]	OutDistance		the length of the found path
+	 * @param[out]	OutTracks		the indices of the tracks the path leads over in order, including the start and end track
+	 * @return	true if a path was found
+	 */
+	bool FindPath(const FFINTrackGraphPosition& From, const FFINTrackGraphPosition& To, float& OutDistance, TArray<int32>& OutTracks) const;
+
+	/**
+	 * Calculates the shortest distances between all the given positions.
+	 *
+	 * @param[in]	Positions		the positions you want the distances of
+	 * @param[out]	OutDistances	row major matrix of the distances from one position to another, negative if there is no path
+	 */
+	void GetDistances(const TArray<FFINTrackGraphPosition>& Positions, TArray<float>& OutDistances) const;
+
+private:
+	void Dijkstra(const FFINTrackGraphPosition& From, TArray<float>& OutDistances, TArray<int32>& OutPrevious, TFunctionRef<bool(float)> ShouldContinue) const;
+	float GetDistanceTo(const FFINTrackGraphPosition& From, const FFINTrackGraphPosition& To, const TArray<float>& Distances, int32& OutEntryNode) const;
+};
+
 /**
  * Stores a track graph ID and a network trace to object
  * that refers to the track graph (like train, railroad vehicle, track, station).
@@ -23,4 +92,37 @@ struct FICSITNETWORKS_API FFINTrackGraph {
 	static int GetTrackID(UObject* obj);
 
 	bool IsValid();
+
+	/**
+	 * Makes sure a snapshot of the track graph with the given ID is cached, only captures one if none is cached yet.
+	 * Has to be called in sync with the game thread, so the snapshot is available for queries from the async runtime.
+	 * Snapshots get dropped once tracks or stations get built, or once a query finds removed tracks in them.
+	 * Also drops cached snapshots of track graphs that no longer exist when capturing.
+	 */
+	static void CacheSnapshot(UObject* WorldContext, int TrackID);
+
+	/**
+	 * Returns the cached snapshot of this track graph.
+	 * Outside of the game thread only the cached snapshot is used and the world doesn't get touched,
+	 * a dropped snapshot gets recaptured by the next sync getTrackGraph call.
+	 * Throws a FFINException if the graph is outdated or no snapshot is available.
+	 */
+	TSharedRef<const FFINTrackGraphSnapshot> GetSnapshot();
+
+	/**
+	 * Drops the given snapshot from the cache and throws a FFINException telling to get the track graph again.
+	 * Used by queries which found tracks removed since the snapshot got captured.
+	 */
+	static void ThrowOutdatedSnapshot(const TSharedRef<const FFINTrackGraphSnapshot>& Snapshot);
+
+private:
+	static FCriticalSection SnapshotCacheMutex;
+	static TMap<int, TSharedRef<const FFINTrackGraphSnapshot>> SnapshotCache;
+
+	/**
+	 * The worlds the snapshots get invalidated in when tracks or stations get built
+	 */
+	static TMap<TWeakObjectPtr<UWorld>, FDelegateHandle> ObservedWorlds;
+
+	static void OnActorSpawned(AActor* Actor);
 };